@@ -22,19 +22,19 @@ typedef struct {
 } gui_grabbed_t;
 
 
-/// State shared between engine thread and the gui thread
+/// State shared between the engine's search thread and the gui thread
 typedef struct {
     max_state_t buffer[1024];
     /// Engine state including the game board
     max_engine_t engine;
-    /// A list of all valid moves for the player, filled by the engine thread
+    /// A list of all valid moves for the player, filled once the engine has played its move
     max_movelist_t moves;
-    /// Lock preventing simultaneous acccess to the board
-    SDL_sem *lock;
-    /// Set while the GUI has a lock indicating that the engine thread should exit
-    bool quit;
-    /// Set when the engine thread is finished processing
-    volatile bool done;
+    /// Set while the engine is searching on its own thread, during which the board must not be modified
+    bool thinking;
+    /// Monotonic clock time in milliseconds when the engine began its current search
+    uint64_t started;
+    /// Set once the engine has found that the game is over
+    bool gameover;
 } gui_shared_t;
 
 /// State for pawn promotion
@@ -50,8 +50,6 @@ typedef struct {
 typedef struct {
     SDL_Window *window;
     SDL_Renderer *render;
-    /// Thread that the engine runs in
-    SDL_Thread *thread;
     /// State that the engine thread has access to
     gui_shared_t *shared;
 
@@ -77,5 +75,13 @@ void gui_state_destroy(gui_state_t *state);
 /// Load all textures from their embedded binary
 int gui_textures_load(SDL_Renderer *render, gui_textures_t *texture);
 
-/// Function to start as a thread in SDL
-int gui_engine_thread(void* data);
+/// Start the engine searching for its next move on its own thread
+/// \return false if the search could not be started
+bool gui_engine_start(gui_shared_t *data);
+
+/// Check if the engine has finished searching, and play its move on the board if it has
+/// \return true if the engine played a move and the player may now move
+bool gui_engine_poll(gui_shared_t *data);
+
+/// Stop any search in progress and wait for the engine to finish
+void gui_engine_quit(gui_shared_t *data);
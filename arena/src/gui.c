@@ -8,9 +8,13 @@
 #include <SDL.h>
 #include <SDL_events.h>
 #include <SDL_mouse.h>
-#include <SDL_mutex.h>
 #include <SDL_render.h>
 #include <SDL_video.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 int gui_state_new(gui_state_t *state) {
     int ec;
@@ -46,7 +50,7 @@ int gui_state_new(gui_state_t *state) {
 
     static const unsigned BOARD_STACK_CAP  = 100;
     static const unsigned MOVELIST_CAP     = 70 * MAX_ENGINE_MAX_MOVES_PER_PLY;
-    static const unsigned TTBL_BUF_CAP_BIT = 23;
+    static const unsigned TTBL_BUF_CAP_BIT = 21;
     static const unsigned TTBL_BUF_CAP     = (1 << TTBL_BUF_CAP_BIT);
     
     max_engine_init_params_t init = (max_engine_init_params_t){
@@ -55,7 +59,11 @@ int gui_state_new(gui_state_t *state) {
             .capacity = BOARD_STACK_CAP
         },
         .ttbl = {
-            .buf = malloc(sizeof(max_ttentry_t) * TTBL_BUF_CAP),
+#ifdef _WIN32
+            .buf = _aligned_malloc(sizeof(max_ttbucket_t) * TTBL_BUF_CAP, MAX_TTBUCKET_SIZE),
+#else
+            .buf = aligned_alloc(MAX_TTBUCKET_SIZE, sizeof(max_ttbucket_t) * TTBL_BUF_CAP),
+#endif
             .nbit = TTBL_BUF_CAP_BIT
         },
         .moves = {
@@ -68,14 +76,8 @@ int gui_state_new(gui_state_t *state) {
     max_board_default_pos(&state->shared->engine.board);
     max_movelist_new(&state->shared->moves, malloc(sizeof(max_smove_t) * 128), 128);
 
-    state->shared->quit = false;
-    state->shared->lock = SDL_CreateSemaphore(0);
-
-    state->thread = SDL_CreateThread(gui_engine_thread, "Engine Thread", (void*)state->shared);
-    if(state->thread == NULL) {
-        printf("Failed to create engine thread: %s\n", SDL_GetError());
-        return -1;
-    }
+    state->shared->thinking = false;
+    state->shared->gameover = false;
 
     state->grabbed.grabbed = NULL;
 
@@ -173,12 +175,15 @@ int gui_state_run(gui_state_t *state) {
     state->squarex = w / 8;
     state->squarey= h / 8;
 
-    volatile bool enginedone = false;
-    SDL_SemPost(state->shared->lock);
+    bool enginedone = false;
+    if(!gui_engine_start(state->shared)) {
+        return -1;
+    }
 
     for(;;) {
     outer:
-        enginedone = state->shared->done;
+        gui_engine_poll(state->shared);
+        enginedone = !state->shared->thinking && !state->shared->gameover;
         
         SDL_Event event;
         SDL_RenderClear(state->render);
@@ -225,10 +230,6 @@ int gui_state_run(gui_state_t *state) {
                                 max_movelist_t moves = state->shared->moves;
                                 for(unsigned i = 0; i < moves.len; ++i) {
                                     max_smove_t move = moves.buf[i];
-                                    if(!max_board_legal(&state->shared->engine.board, move)) {
-                                        continue;
-                                    }
-
                                     if(move.from.v == state->grabbed.from.v && move.to.v == to.v) {
                                         if(max_movetag_is_promote(move.tag)) {
                                             if(!state->promote.selecting) {
@@ -247,7 +248,9 @@ int gui_state_run(gui_state_t *state) {
                                         max_board_make_move(&state->shared->engine.board, move);
                                         gui_state_drop_grabbed(state);
                                         enginedone = false;
-                                        SDL_SemPost(state->shared->lock);
+                                        if(!gui_engine_start(state->shared)) {
+                                            return -1;
+                                        }
                                         break;
                                     }
                                 }
@@ -277,11 +280,7 @@ int gui_state_run(gui_state_t *state) {
 }
 
 void gui_state_destroy(gui_state_t *state) {
-    state->shared->quit = true;
-    SDL_SemPost(state->shared->lock);
-
-    int status;
-    SDL_WaitThread(state->thread, &status);
+    gui_engine_quit(state->shared);
 
     free(state->shared->moves.buf);
 
@@ -1,58 +1,69 @@
 #include "gui.h"
 #include "max/board/movegen.h"
-#include <SDL_error.h>
-#include <SDL_timer.h>
+#include <stdio.h>
 
-#define NODEFMT(nodes) ((nodes) / 1000000), (((nodes) - (((nodes) / 1000000) * 1000000)) / 10000)
+/// Search limits applied to every move played by the engine
+static const max_search_limits_t GUI_ENGINE_LIMITS = { .movetime = 10000 };
+
+bool gui_engine_start(gui_shared_t *data) {
+    if(!max_engine_search_start(&data->engine, &GUI_ENGINE_LIMITS, false)) {
+        printf("Failed to start engine search thread\n");
+        return false;
+    }
+
+    data->started = max_engine_clock_ms();
+    data->thinking = true;
+    return true;
+}
+
+bool gui_engine_poll(gui_shared_t *data) {
+    if(!data->thinking || !max_engine_search_done(&data->engine)) {
+        return false;
+    }
 
-int gui_engine_thread(void *_data) {
-    gui_shared_t *data = (gui_shared_t*)_data;
     max_search_result_t search;
+    max_engine_search_wait(&data->engine, &search);
+    data->thinking = false;
 
-    for(;;) {
-        if(SDL_SemWait(data->lock) == 0) {
-            data->done = false;
-            if(data->quit) {
-                break;
-            }
-            
-            uint64_t start = SDL_GetTicks64();
-            max_engine_search(&data->engine, &search);
-            if(search.gameover) {
-                printf("checkmate\n");
-                return 0;
-            }
-            double time = (double)(SDL_GetTicks64() - start) / 1000;
-            double meganodes = (double)(data->engine.diagnostic.nodes) / 1000000;
-            uint64_t tt_hits = data->engine.diagnostic.ttbl_hits;
-            uint64_t tt_used = data->engine.diagnostic.ttbl_used;
-            double util_rate = (double)(tt_used) / (double)(tt_hits);
-
-            double mn_s = meganodes / time;
-            printf(
-                "%c%c%c%c @ %-5d - depth %-2u [%-1.2f s][%3.2f MN | %-1.2f MN/s] %8zu / %-8zu TT Used / Hits (%.3f TTUR)\n",
-                MAX_0x88_FORMAT(search.best.from),
-                MAX_0x88_FORMAT(search.best.to),
-                search.score,
-                search.depth,
-                time,
-                meganodes,
-                mn_s,
-                tt_used,
-                tt_hits,
-                util_rate
-            );
-
-            max_board_make_move(&data->engine.board, search.best);
-
-            max_movelist_clear(&data->moves);
-            max_board_movegen(&data->engine.board, &data->moves);
-            data->done = true;
-        } else {
-            printf("Failed to wait semaphore in engine thread: %s\n", SDL_GetError());
-            break;
-        }
+    if(search.gameover) {
+        printf("checkmate\n");
+        data->gameover = true;
+        return false;
     }
 
-    return 0;
+    double time = (double)(max_engine_clock_ms() - data->started) / 1000;
+    double meganodes = (double)(data->engine.diagnostic.nodes) / 1000000;
+    uint64_t tt_hits = data->engine.diagnostic.ttbl_hits;
+    uint64_t tt_used = data->engine.diagnostic.ttbl_used;
+    double util_rate = (double)(tt_used) / (double)(tt_hits);
+
+    double mn_s = meganodes / time;
+    printf(
+        "%c%c%c%c @ %-5d - depth %-2u [%-1.2f s][%3.2f MN | %-1.2f MN/s] %8zu / %-8zu TT Used / Hits (%.3f TTUR)\n",
+        MAX_0x88_FORMAT(search.best.from),
+        MAX_0x88_FORMAT(search.best.to),
+        search.score,
+        search.depth,
+        time,
+        meganodes,
+        mn_s,
+        tt_used,
+        tt_hits,
+        util_rate
+    );
+
+    max_board_make_move(&data->engine.board, search.best);
+
+    max_movelist_clear(&data->moves);
+    max_board_movegen_legal(&data->engine.board, &data->moves);
+    return true;
+}
+
+void gui_engine_quit(gui_shared_t *data) {
+    if(data->thinking) {
+        max_search_result_t search;
+        max_engine_stop(&data->engine);
+        max_engine_search_wait(&data->engine, &search);
+        data->thinking = false;
+    }
 }
@@ -17,6 +17,14 @@
 ///
 /// In exchange, transposition table entries grow by a few bytes to accomodate the larger key size,
 /// potentially causing a very large memory usage increase over 32-bit keys depending on the size of the table.
+///
+/// \subsection MAX_THREADS
+/// When enabled, the engine can search with multiple threads using lazy SMP.
+/// A number of helper threads, each owning a private board and move stack, search the same root position
+/// alongside the calling thread and share results only through the transposition table.
+/// This requires C11 `<threads.h>` and `<stdatomic.h>` support from the target platform, which MSVC provides from
+/// Visual Studio 2022 17.8 with the `/experimental:c11atomics` switch that the CMake build adds.
+/// Builds without threads use neither header.
 
 /// Initialize all static lookup tables used by the engine.
 /// This function must be called before any boards are created (checked when MAX_ASSERTS is on)
@@ -13,6 +13,7 @@
 #include "max/board/loc.h"
 #include "max/board/piececode.h"
 #include "max/board/piecelist.h"
+#include "max/board/psqt.h"
 #include "max/def.h"
 
 /// \defgroup board Chessboard
@@ -79,6 +80,16 @@ typedef struct {
     /// This counter is also used to derive the current #max_side_t index by bitwise ANDing
     /// with 1 (e.g. an odd ply means black is to move on that ply)
     uint16_t ply;
+
+    /// Scores of each piece on each square, summed into #score as pieces are added, moved, and removed.
+    /// Defaults to a table of zero scores until one is set with max_board_set_psqt().
+    max_psqt_t const *psqt;
+    /// Sum of the #psqt scores of every piece on the board from white's perspective.
+    /// This is kept up to date by the piece bookkeeping of move making and unmaking, so unmaking a move restores
+    /// the value it had before the move was made.
+    max_phasescore_t score;
+    /// Sum of the #psqt phase weights of every piece on the board, maintained in the same way as #score
+    uint8_t phase;
 } max_board_t;
 
 /// Create a new chessboard with no pieces on the board and a default state
@@ -89,6 +100,21 @@ typedef struct {
 /// \param [in] seed Seed to use for the random number generator when creating zobrist elements
 void max_board_new(max_board_t *board, max_state_t *buffer, uint64_t seed);
 
+/// Copy the full state of a chessboard into another board that will maintain its own state stack.
+/// This allows the copy to make and unmake moves independently of the original board, for example when
+/// searching the same position from multiple threads.
+/// \param [out] dst Board that will be overwritten with the state of the source board
+/// \param [in] src Board to copy pieces and game state from
+/// \param [in] buffer Buffer for the copy's state stack, which must have capacity for at least as many
+/// elements as are currently on the source board's stack
+void max_board_clone(max_board_t *dst, max_board_t const *src, max_state_t *buffer);
+
+/// Set the piece-square score table that the board accumulates into max_board_t::score, recomputing the score of
+/// all pieces already on the board.
+/// The table is not copied and must remain valid for as long as the board, and any clone of it, is in use.
+/// \param [in] psqt Table of scores for each piece on each square, or NULL to stop accumulating scores
+void max_board_set_psqt(max_board_t *board, max_psqt_t const *psqt);
+
 /// Reset the given chessboard, removing any pieces and resetting the capture and state stacks.
 void max_board_reset(max_board_t *board);
 
@@ -139,6 +139,22 @@ MAX_INLINE_ALWAYS max_smove_t max_smove_normal(max_0x88_t from, max_0x88_t to) {
     return max_smove_new(from, to, MAX_MOVETAG_NONE);
 }
 
+/// Create a placeholder #max_smove_t that represents the absence of a move.
+/// The placeholder moves a piece from a square to the same square, which can never be generated or played.
+MAX_INLINE_ALWAYS max_smove_t max_smove_none(void) {
+    return max_smove_normal(max_0x88_raw(0), max_0x88_raw(0));
+}
+
+/// Check if the given move is a placeholder created by max_smove_none()
+MAX_INLINE_ALWAYS bool max_smove_is_none(max_smove_t move) {
+    return move.from.v == move.to.v;
+}
+
+/// Check if the two given moves have the same source, destination, and tag.
+MAX_INLINE_ALWAYS bool max_smove_eq(max_smove_t a, max_smove_t b) {
+    return a.from.v == b.from.v && a.to.v == b.to.v && a.tag == b.tag;
+}
+
 /// A list of (optionally packed) moves filled during movegen and searched
 /// by the engine. Because the engine must perform move ordering to maximize
 /// the number of pruned nodes during a search, the full list of every possible move
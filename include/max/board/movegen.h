@@ -4,7 +4,11 @@
 
 
 #include "max/board/board.h"
+#include "max/board/dir.h"
+#include "max/board/loc.h"
 #include "max/board/move.h"
+#include "max/def.h"
+#include <stdint.h>
 
 /// \ingroup board
 /// @{
@@ -18,10 +22,77 @@
 /// on the board.
 void max_board_movegen(max_board_t *board, max_movelist_t *list);
 
+/// Fill a movelist with only the pseudolegal captures, en passant captures, and promotions for the current side to play.
+/// No quiet moves are generated, making this suitable for quiescence search where only material-changing moves
+/// are considered.
+/// \see max_board_movegen_quiets()
+void max_board_movegen_captures(max_board_t *board, max_movelist_t *list);
+
+/// Fill a movelist with the pseudolegal moves not generated by max_board_movegen_captures(), so that the two
+/// together produce the same moves as max_board_movegen().
+void max_board_movegen_quiets(max_board_t *board, max_movelist_t *list);
+
 /// Check if the given pseudo-legal move is valid on the board - that is, it does not leave a
 /// king in check and doesn't exit a pin line
 bool max_board_legal(max_board_t *board, max_smove_t move);
 
+/// Pins and check evasion squares for the side to play, computed once per position so that every generated move
+/// can be validated with a few bit tests instead of re-scanning the board with max_board_legal().
+/// Both masks are indexed by the #max_6bit_t representation of a square.
+typedef struct {
+    /// Location of the king of the side to play
+    max_0x88_t king;
+    /// Squares containing pieces of the side to play that are pinned to their king by an enemy slider
+    uint64_t pinned;
+    /// Squares that pieces other than the king may move to - every square when not in check, the checking piece and
+    /// any squares between it and the king in single check, and no squares in double check
+    uint64_t evasions;
+} max_legalmask_t;
+
+/// Get the bit representing the given square in a #max_legalmask_t
+MAX_INLINE_ALWAYS uint64_t max_legalmask_bit(max_0x88_t pos) {
+    return (uint64_t)1 << max_0x88_to_6bit(pos).v;
+}
+
+/// Compute the pinned pieces and check evasion squares for the side to play.
+void max_board_legalmask(max_board_t *board, max_legalmask_t *mask);
+
+/// Check if the given pseudo-legal move is legal using the masks computed by max_board_legalmask() for the current position.
+/// King moves and en passant captures are rare enough that they fall back to max_board_legal().
+MAX_INLINE_ALWAYS bool max_board_legal_masked(max_board_t *board, max_legalmask_t const *mask, max_smove_t move) {
+    //King moves must test their destination for attacks, and en passant can expose a pin along the rank through both pawns
+    if(move.from.v == mask->king.v || move.tag == MAX_MOVETAG_ENPASSANT) {
+        return max_board_legal(board, move);
+    }
+
+    if((mask->evasions & max_legalmask_bit(move.to)) == 0) {
+        return false;
+    }
+
+    return
+        (mask->pinned & max_legalmask_bit(move.from)) == 0 ||
+        max_0x88_line(mask->king, move.to) == max_0x88_line(mask->king, move.from);
+}
+
+/// Remove every illegal move at or after the given index from the movelist, preserving the order of the remaining moves.
+/// \param start Index of the first move in the list to validate
+void max_board_movegen_retain_legal(max_board_t *board, max_legalmask_t const *mask, max_movelist_t *list, uint16_t start);
+
+/// Fill a movelist with pseudolegal moves that may escape check for the side to play, which must be in check.
+/// Only king moves are generated in double check, and all other pieces only generate moves to the squares of
+/// #max_legalmask_t::evasions.
+void max_board_movegen_evasions(max_board_t *board, max_movelist_t *list, max_legalmask_t const *mask);
+
+/// Fill a movelist with all legal moves for the side to play, using the check evasion generator when in check.
+/// Generated moves may be played on the board without validation.
+void max_board_movegen_legal(max_board_t *board, max_movelist_t *list);
+
+/// Check if the given move could have been generated by max_board_movegen() in the current position.
+/// This is used to validate moves from an untrusted source, such as a transposition table entry that may have been
+/// produced by a different position, without generating every move for the side to play.
+/// Moves that pass this check must still be validated with max_board_legal() before they are played.
+bool max_board_pseudolegal(max_board_t *board, max_smove_t move);
+
 /// Make the given move on the board, changing the ply counter, adjusting any captures made,
 /// and pushing a new state to the stack.
 /// \note The passed move must be checked for legality before the move is made
@@ -31,6 +102,14 @@ void max_board_make_move(max_board_t *board, max_smove_t move);
 /// \param move The last move that was played
 void max_board_unmake_move(max_board_t *board, max_smove_t move);
 
+/// Pass the turn to the other side without moving any pieces, as used by null move pruning.
+/// Only a new state plate is pushed with en passant cleared, leaving the piece lists untouched.
+/// \note The side to play must not be in check
+void max_board_make_null(max_board_t *board);
+
+/// Unmake a null move made by max_board_make_null(), restoring the turn to the side that passed
+void max_board_unmake_null(max_board_t *board);
+
 /// @}
 
 /// @}
@@ -0,0 +1,55 @@
+/// \file psqt.h
+
+#pragma once
+
+#include "max/board/side.h"
+#include "max/board/loc.h"
+#include "max/board/piececode.h"
+#include "max/def.h"
+#include <stdint.h>
+
+/// \ingroup board
+/// @{
+
+/// \defgroup boardpsqt Incremental Piece-Square Scores
+/// The board keeps a running sum of a score assigned to every piece on its square, updated by the difference of a
+/// single table lookup whenever a piece is added, moved, or removed.
+/// This lets an evaluation read the material and piece-square terms of a position without iterating any piece lists.
+/// The same bookkeeping maintains a game phase from a weight given to each piece type, which an evaluation can use to
+/// interpolate between the midgame and endgame scores.
+/// The board does not know the meaning of these scores - the table is built from evaluation parameters by the engine
+/// and handed to the board with max_board_set_psqt().
+/// @{
+
+/// A pair of scores for the same term, weighted for the midgame and endgame
+typedef struct {
+    int16_t mg;
+    int16_t eg;
+} max_phasescore_t;
+
+/// Scores of every piece on every square, already mirrored for black and negated so that black pieces subtract from
+/// the sum.
+/// Indexed in the same way as the zobrist position elements, by side, piece type index, and #max_6bit_t square.
+typedef struct {
+    max_phasescore_t score[MAX_SIDES_LEN][MAX_PIECEINDEX_LEN][MAX_6BIT_LEN];
+    /// Weight of each piece type indexed by #max_pieceindex_t, summed into the phase of the board
+    uint8_t phase[MAX_PIECEINDEX_LEN];
+    /// Phase of a board with all pieces in their starting positions, which may be exceeded after promotions
+    uint8_t phase_max;
+} max_psqt_t;
+
+/// Add the given score pair to an accumulator
+MAX_INLINE_ALWAYS void max_phasescore_add(max_phasescore_t *acc, max_phasescore_t score) {
+    acc->mg += score.mg;
+    acc->eg += score.eg;
+}
+
+/// Subtract the given score pair from an accumulator
+MAX_INLINE_ALWAYS void max_phasescore_sub(max_phasescore_t *acc, max_phasescore_t score) {
+    acc->mg -= score.mg;
+    acc->eg -= score.eg;
+}
+
+/// @}
+
+/// @}
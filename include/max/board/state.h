@@ -119,6 +119,12 @@ typedef struct {
     /// Zobrist hash of this position, saved in order to determine draw by threefold repetition.
     /// Fingers crossed that someone isn't extremely unlucky and three separate key collisions occur :)
     max_zobrist_t position;
+    /// Zobrist hash of only the pawns of both sides, identifying the pawn structure of this position
+    /// independently of the placement of other pieces.
+    max_zobrist_t pawns;
+    /// Zobrist hash of the number of pieces of each type and color, identifying the material balance of this position
+    /// regardless of where the pieces are placed.
+    max_zobrist_t material;
     /// An array of two separate check structures, if one or both of these structures
     /// is valid then the side to play is in check and must escape in order to continue the game.
     /// The first (index 0) check structure will always be set to indicate single check, while the second
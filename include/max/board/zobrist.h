@@ -36,6 +36,10 @@ typedef uint32_t max_zobrist_t;
 
 /// @}
 
+/// Number of material elements for each side and piece type, enough for the greatest number of pieces of a single
+/// type that a side can have on the board
+#define MAX_ZOBRIST_MATERIAL_COUNT (10)
+
 /// Static arrays used to incrementally compute zobrist hash keys.
 /// These contribute the largest memory footprint to the board by itself,
 /// but allow for huge performance gains in engine processing and threefold repetition.
@@ -50,6 +54,14 @@ typedef struct {
     /// Elements added to the final hash if en passant is possible on a file, otherwise no extra
     /// element is added
     max_zobrist_t en_passant_file[8];
+    /// Element added to the hash when black is to play, so that the same arrangement of pieces is not
+    /// confused between sides - in particular after a null move, which changes nothing but the side to play
+    max_zobrist_t black_to_play;
+    /// An array indexed by side, piece type, and the number of pieces of that type that the side had before a piece
+    /// was added.
+    /// The material key of a position contains one element for every piece of each type, identifying the number of
+    /// pieces of each type without regard to where they are placed
+    max_zobrist_t material[MAX_SIDES_LEN][MAX_PIECEINDEX_LEN][MAX_ZOBRIST_MATERIAL_COUNT];
 } max_zobrist_elements_t;
 
 /// Default seed for the random number generator used to create zobrist hash elements when creating a board.
@@ -15,3 +15,17 @@
 #endif
 
 /// @}
+
+/// Hint to the processor that the memory at the given address will soon be read, on supported compilers
+/// @{
+#ifdef __GNUC__
+
+#define MAX_PREFETCH(addr) __builtin_prefetch((addr))
+
+#else
+
+#define MAX_PREFETCH(addr) ((void)(addr))
+
+#endif
+
+/// @}
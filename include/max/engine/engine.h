@@ -1,23 +1,212 @@
 #pragma once
 #include "max/board/board.h"
 #include "max/board/state.h"
+#include "max/engine/eval/cache.h"
+#include "max/engine/eval/endgame.h"
 #include "max/engine/eval/param.h"
+#include "max/engine/eval/pawns.h"
 #include "max/engine/tt.h"
 
+#ifdef MAX_THREADS
+#include <stdatomic.h>
+#include <threads.h>
+#endif
+
 /// \defgroup engine Chess Engine
 /// The actual chess engine including search algorithm and transposition table.
 /// @{
 
+/// Maximum number of plies from the root position that the engine will descend to during a search.
+/// This bounds the per-ply storage required by helper threads when searching in parallel.
+#define MAX_ENGINE_MAX_PLY (64)
+
+/// Maximum nominal depth of an iterative deepening iteration.
+/// Leaves room in the per-ply storage for check extensions and the plies searched by quiescence below the nominal depth.
+#define MAX_ENGINE_MAX_DEPTH (MAX_ENGINE_MAX_PLY - 16)
+
+/// Number of killer moves remembered for every ply of the search
+#define MAX_ENGINE_KILLERS_LEN (2)
+
+/// Upper bound on the magnitude of a butterfly history score
+#define MAX_ENGINE_HISTORY_MAX (16384)
+
+/// Search state kept for a single ply of the line currently being searched
+typedef struct {
+    /// Quiet moves that most recently caused a beta cutoff at this ply, most recent first
+    max_smove_t killers[MAX_ENGINE_KILLERS_LEN];
+    /// The move currently being searched from this ply, used by the child ply to find its countermove
+    max_smove_t move;
+} max_engine_ply_t;
+
+/// Quiet move ordering heuristics learned from beta cutoffs during search.
+/// Killers are cleared and history scores are aged before every search, while countermoves are kept between searches.
+typedef struct {
+    /// Per-ply search stack indexed by the distance from the root position
+    max_engine_ply_t stack[MAX_ENGINE_MAX_PLY];
+    /// Butterfly history table indexed by side to play and the #max_6bit_t source and destination squares of a quiet
+    /// move, rewarding moves that cause cutoffs and penalizing quiet moves searched before them
+    int16_t history[MAX_SIDES_LEN][MAX_6BIT_LEN][MAX_6BIT_LEN];
+    /// Quiet move that last refuted the opponent's move, indexed by the #max_6bit_t source and destination squares
+    /// of the opponent's move
+    max_smove_t counter[MAX_6BIT_LEN][MAX_6BIT_LEN];
+} max_engine_heuristics_t;
+
+/// Triangular table of the principal variations found below every ply of the line currently being searched.
+/// The line found from ply `p` is stored in `line[p][p]` up to `line[p][len[p] - 1]`, and is built by prepending the
+/// move that raised alpha at `p` to the line of ply `p + 1`, so that only the upper triangle of the table is used.
+typedef struct {
+    /// Principal variation of every ply, indexed by the ply it begins from and the ply of each move
+    max_smove_t line[MAX_ENGINE_MAX_PLY][MAX_ENGINE_MAX_PLY];
+    /// Ply one past the last move of the principal variation beginning at each ply
+    uint8_t len[MAX_ENGINE_MAX_PLY];
+    /// Principal variation of the last iteration, replayed first by the next iteration
+    max_smove_t follow[MAX_ENGINE_MAX_PLY];
+    /// Number of moves in #follow
+    uint8_t follow_len;
+    /// Set while the search is descending the first branch of #follow, cleared at the first node that yields
+    /// a move not on the previous principal variation
+    bool following;
+} max_engine_pv_t;
+
+/// Conditions under which a search must stop, mirroring the limits of a UCI `go` command.
+/// A limit with a value of zero is not applied, so a zero-initialized structure searches until the maximum depth.
+typedef struct {
+    /// Exact time in milliseconds to spend on the search
+    uint32_t movetime;
+    /// Time in milliseconds remaining on white's clock
+    uint32_t wtime;
+    /// Time in milliseconds remaining on black's clock
+    uint32_t btime;
+    /// Increment in milliseconds added to white's clock after every move
+    uint32_t winc;
+    /// Increment in milliseconds added to black's clock after every move
+    uint32_t binc;
+    /// Maximum number of nodes visited by the searching thread
+    uint64_t nodes;
+    /// Maximum nominal depth of iterative deepening, capped to #MAX_ENGINE_MAX_DEPTH
+    uint8_t depth;
+} max_search_limits_t;
+
+/// Maximum number of principal variations that a multi-PV search may report
+#define MAX_ENGINE_MULTIPV_MAX (8)
+
+/// A single scored principal variation found by a search
+typedef struct {
+    /// Score of the line from the perspective of the side to play at the root
+    max_score_t score;
+    /// Number of moves in #pv
+    uint8_t pv_len;
+    /// Moves of the line beginning with a root move
+    max_smove_t pv[MAX_ENGINE_MAX_PLY];
+} max_search_line_t;
+
+/// The result of a completed search, indicating the best move,
+/// and the score assigned to that move.
+typedef struct {
+    max_score_t score;
+    max_smove_t best;
+    uint8_t depth;
+    bool gameover;
+    /// Total number of nodes visited by the search, summed over all threads
+    uint64_t nodes;
+    /// Aggregate search speed of all threads in nodes per second
+    uint64_t nps;
+    /// Microseconds between the call to max_engine_stop() and the search returning, or 0 if the search was
+    /// not stopped externally
+    uint64_t stop_latency;
+    /// Number of lines in #lines
+    uint8_t lines_len;
+    /// Best lines found by the search in order, each beginning with a different root move.
+    /// The first line is the principal variation of #best, and further lines are only searched in multi-PV mode.
+    /// \see max_engine_set_multipv()
+    max_search_line_t lines[MAX_ENGINE_MULTIPV_MAX];
+} max_search_result_t;
+
+/// Report of a running search passed to a #max_search_info_fn, mirroring the fields of a UCI `info` line
+typedef struct {
+    /// Iterative deepening depth that the report describes
+    uint8_t depth;
+    /// Deepest distance from the root reached by the main search thread in this iteration, including quiescence
+    uint8_t seldepth;
+    /// Score of the principal variation from the perspective of the side to play at the root
+    max_score_t score;
+    /// Number of nodes searched so far, summed over all threads
+    uint64_t nodes;
+    /// Aggregate search speed of all threads in nodes per second
+    uint64_t nps;
+    /// Milliseconds elapsed since the search began
+    uint64_t time;
+    /// Permille of the transposition table filled by the current search, see max_ttbl_hashfull()
+    uint16_t hashfull;
+    /// true if the report was sent after an iteration completed, or false if it was sent periodically while
+    /// #depth is being searched, in which case #score and #pv are those of the last completed iteration
+    bool complete;
+    /// One-based index of the line described by the report, completed iterations of a multi-PV search send one
+    /// report for every line
+    uint8_t multipv;
+    /// Number of moves in #pv
+    uint8_t pv_len;
+    /// Principal variation beginning with the best move found at the root
+    max_smove_t pv[MAX_ENGINE_MAX_PLY];
+} max_search_info_t;
+
+/// Callback receiving reports of a running search, invoked on the thread that is running the search.
+/// The callback must return quickly as the search does not continue until it has returned.
+/// \param data User data pointer given to max_engine_set_info()
+typedef void (*max_search_info_fn)(max_search_info_t const *info, void *data);
+
+/// Number of move iterations of interior nodes between polls of the clock and stop flag.
+/// Stop conditions are checked before every move after the first searched from a node of the main search, but
+/// quiescence search never checks them, so the latency of a stop is bounded by the time taken to search this many
+/// interior moves along with the quiescence searches below them.
+#define MAX_ENGINE_POLL_INTERVAL (1024)
+
+/// Time in milliseconds kept in reserve on the clock for the latency of communicating a move
+#define MAX_ENGINE_MOVE_OVERHEAD (30)
+
+/// Expected number of moves remaining in the game when allocating time from a clock without a moves-to-go count
+#define MAX_ENGINE_MOVES_TO_GO (30)
+
 #ifdef MAX_ENGINE_DIAGNOSTIC
 
 typedef struct {
     uint64_t nodes;
     uint64_t ttbl_hits;
     uint64_t ttbl_used;
+    /// Number of nodes that were cut off by the hash move before any moves were generated
+    uint64_t ttbl_cutoffs;
+    /// Number of static evaluations looked up in the evaluation cache
+    uint64_t evalcache_probes;
+    /// Number of static evaluations returned from the evaluation cache without evaluating the position
+    uint64_t evalcache_hits;
 } max_engine_diagnostic_t;
 
 #endif
 
+/// \name Shared Search State
+/// Flags and counters of an engine that may be written by one thread while a search reads them on another.
+/// When multiple threads are enabled they are atomic, otherwise they are only volatile so that a search still observes
+/// a stop requested from its info callback or a signal handler.
+/// @{
+
+#ifdef MAX_THREADS
+typedef atomic_bool max_engine_flag_t;
+typedef atomic_uint_fast64_t max_engine_word_t;
+#else
+typedef volatile bool max_engine_flag_t;
+typedef volatile uint64_t max_engine_word_t;
+#endif
+
+/// @}
+
+#ifdef MAX_THREADS
+
+/// Storage for a helper thread participating in a lazy SMP search.
+/// \see #max_engine_helper
+typedef struct max_engine_helper max_engine_helper_t;
+
+#endif
+
 /// All state required by the chess engine to search a game tree and evaluate positions.
 /// Includes a pointer to a #max_board_t that will be used to search a tree by making and unmaking moves,
 /// and configurable evaluation parameters.
@@ -29,6 +218,16 @@ typedef struct {
     max_board_t board;
     /// Evaluation parameters used to fine tune the behavior of the engine.
     max_eval_params_t param;
+    /// Material and piece-square scores built from #param, accumulated by the board as moves are made and unmade
+    max_psqt_t psqt;
+    /// Cached evaluations of the pawn structures reached by this engine's search.
+    /// This and the other evaluation tables below belong to a single engine, and every helper thread searches with
+    /// its own copy, so they are read and written without atomics or locks unlike the shared #table.
+    max_pawntbl_t pawns;
+    /// Cached evaluations of the material balances reached by this engine's search
+    max_materialtbl_t materials;
+    /// Static evaluations of the positions most recently evaluated by this engine
+    max_evalcache_t evals;
     
     #ifdef MAX_ENGINE_DIAGNOSTIC
 
@@ -42,10 +241,138 @@ typedef struct {
     max_ttbl_t table;
     /// Move list used to store moves that lead to lower positions in the game tree search
     max_movelist_t moves;
+    /// Killer, history, and countermove tables used to order quiet moves
+    max_engine_heuristics_t heuristics;
+    /// Principal variations of the current line, and the line of the last iteration that is searched first
+    max_engine_pv_t pv;
+    /// Number of principal variations searched at the root, see max_engine_set_multipv()
+    uint8_t multipv;
+    /// Ply of the board when the current search began, used to find the distance of a node from the root
+    uint16_t root_ply;
+    /// Distance from the root below which null moves are not tried, raised while a null move cutoff is verified
+    uint8_t null_min_ply;
+    /// Number of check extensions applied to the line currently being searched
+    uint8_t extensions;
+    
+    /// Number of nodes visited by this engine in the current search, not including helper threads.
+    uint64_t nodes;
+    /// Deepest distance from the root reached in the current iteration, including quiescence search
+    uint8_t seldepth;
 
-    uint64_t time;
+    /// Subscriber to reports of the search's progress, set with max_engine_set_info()
+    struct {
+        /// Function invoked with every report, or NULL to disable reports
+        max_search_info_fn callback;
+        /// User data passed to every invocation of #callback
+        void *data;
+        /// Minimum number of milliseconds between periodic reports sent while an iteration is in progress,
+        /// or 0 to only report completed iterations
+        uint32_t interval;
+        /// Monotonic clock time in milliseconds that the current search began
+        uint64_t start;
+        /// Monotonic clock time in milliseconds after which the next periodic report is sent
+        uint64_t next;
+        /// Last report sent for a completed iteration, repeated by periodic reports
+        max_search_info_t last;
+    } info;
+
+    /// Stop conditions of the current search, resolved from the #max_search_limits_t passed to max_engine_search()
+    struct {
+        /// Monotonic clock time in milliseconds after which the search is stopped, or UINT64_MAX for no deadline.
+        /// This is shared as it is reset by max_engine_ponderhit() while the search is running
+        max_engine_word_t deadline;
+        /// Number of nodes after which the search is stopped, or UINT64_MAX for no limit
+        uint64_t nodes;
+        /// Maximum nominal depth of iterative deepening
+        uint8_t depth;
+        /// Number of polls remaining before the clock is next read
+        uint16_t poll;
+        /// Set once any limit has been exceeded, after which every node returns immediately
+        bool stopped;
+    } limits;
+
+    #ifdef MAX_THREADS
+
+    /// Helper threads that search the same root position in parallel with this engine,
+    /// sharing only the transposition table.
+    struct {
+        /// Buffer of helper thread states, each of which owns a private board and move stack.
+        max_engine_helper_t *buf;
+        /// Number of helper threads to start alongside the main search thread
+        uint8_t count;
+        /// Number of helper threads started for the current search
+        uint8_t running;
+    } threads;
+
+    /// State of a search running on its own thread, started by max_engine_search_start()
+    struct {
+        /// Handle of the thread running the search
+        thrd_t thread;
+        /// Limits that the search was started with, kept to allocate time when a ponder search is converted
+        max_search_limits_t limits;
+        /// Side to play at the root of the search, used to allocate time when a ponder search is converted
+        max_side_t side;
+        /// Result of the search, only valid once #done has been set
+        max_search_result_t result;
+        /// Set by the search thread once the result has been written
+        atomic_bool done;
+        /// Set while a search thread has been started and not yet joined by max_engine_search_wait()
+        bool running;
+    } async;
+
+    #endif
+
+    /// Flag owned by this engine that is raised to stop a search early, either by max_engine_stop() or by
+    /// the main search thread to stop its helpers once it has finished
+    max_engine_flag_t stop_signal;
+    /// Pointer to the flag that is polled during search to stop early.
+    /// Helper engines point this to the flag owned by the main engine, and the main engine
+    /// points this at its own flag.
+    max_engine_flag_t *stop;
+    /// Monotonic clock time in microseconds of the last call to max_engine_stop(), or 0 if the current search
+    /// has not been stopped externally. Used to measure the latency of a stop.
+    max_engine_word_t stop_time;
+    /// Set while the engine is pondering, during which the search ignores its time limits and will not
+    /// finish until max_engine_ponderhit() or max_engine_stop() is called
+    max_engine_flag_t ponder;
+
+    /// Progress of the running search that may be read from any thread with max_engine_progress()
+    struct {
+        /// Last iterative deepening depth completed by the main search thread
+        max_engine_word_t depth;
+        /// Nodes searched by the main search thread, updated every time the stop conditions are polled
+        max_engine_word_t nodes;
+    } progress;
 } max_engine_t;
 
+#ifdef MAX_THREADS
+
+/// Capacity of the state stack owned by each helper thread
+#define MAX_ENGINE_HELPER_STACK_CAP (MAX_ENGINE_MAX_PLY + 4)
+
+/// Capacity of the move buffer owned by each helper thread
+#define MAX_ENGINE_HELPER_MOVES_CAP (MAX_ENGINE_MAX_PLY * MAX_ENGINE_MAX_MOVES_PER_PLY)
+
+/// A helper thread for lazy SMP search.
+/// Every helper owns a copy of the main engine with a private board, state stack, and move stack,
+/// while the transposition table buffer is shared between all threads.
+/// These are large structures and should be statically allocated or allocated on the heap by the user.
+struct max_engine_helper {
+    /// Private engine searching a copy of the main engine's board
+    max_engine_t engine;
+    /// Storage for the state stack of the helper's board
+    max_state_t stack[MAX_ENGINE_HELPER_STACK_CAP];
+    /// Storage for moves generated by the helper while searching
+    max_smove_t moves[MAX_ENGINE_HELPER_MOVES_CAP];
+    /// Handle of the running thread
+    thrd_t thread;
+    /// Depth that this helper begins iterative deepening at, staggered between helpers
+    /// so that threads do not all search the same depth at once.
+    uint8_t start_depth;
+};
+
+#endif
+
 /// Parameters used to initialize a #max_engine_t
 typedef struct {
     /// A buffer required for the board's irreversible state stack.
@@ -59,9 +386,10 @@ typedef struct {
 
     /// Transposition table buffer and capacity bits.
     struct {
-        /// A pointer to an allocated buffer used to store entries in the transposition table.
-        /// The capacity of this buffer must be a power of two = 1 << nbit.
-        max_ttentry_t *buf;
+        /// A pointer to an allocated buffer used to store buckets of entries in the transposition table.
+        /// The capacity of this buffer must be a power of two = 1 << nbit buckets,
+        /// and the buffer must be aligned to #MAX_TTBUCKET_SIZE bytes.
+        max_ttbucket_t *buf;
         /// Number of bits to shift left a 1 in order to get the capacity of the provided buffer.
         /// The capacity must be a power of two in order to allow efficient index creation by masking
         /// the lower bits of a zobrist key.
@@ -75,25 +403,100 @@ typedef struct {
         // Capacity of the move buffer in number of elements possible to store.
         uint32_t capacity;
     } moves;
+
+    #ifdef MAX_THREADS
+
+    /// Helper threads used for lazy SMP search.
+    /// Set the count to 0 to search with the calling thread alone.
+    struct {
+        /// Pointer to a buffer of helper thread states with the given capacity
+        max_engine_helper_t *buf;
+        /// Number of helper threads that will search in addition to the calling thread
+        uint8_t count;
+    } threads;
+
+    #endif
 } max_engine_init_params_t;
 
-/// The result of a completed search, indicating the best move,
-/// and the score assigned to that move.
+
+/// Snapshot of a running search's progress
 typedef struct {
-    max_score_t score;
-    max_smove_t best;
+    /// Last iterative deepening depth that has been completed
     uint8_t depth;
-    bool gameover;
-} max_search_result_t;
+    /// Approximate number of nodes searched so far by the main search thread
+    uint64_t nodes;
+} max_search_progress_t;
 
 /// Create a new engine with the given buffers to use for lookup tables.
 /// Automatically initializes the contained board without adding any pieces,
 /// it is the user's responsibility to modify the board after this method to add a starting position.
 void max_engine_new(max_engine_t *engine, max_engine_init_params_t *init, max_eval_params_t param);
 
+/// Get the current time of a monotonic clock in microseconds, used to measure the latency of a stop
+uint64_t max_engine_clock_us(void);
+
+/// Get the current time of a monotonic clock in milliseconds, used to measure and limit the duration of a search
+MAX_INLINE_ALWAYS uint64_t max_engine_clock_ms(void) {
+    return max_engine_clock_us() / 1000;
+}
+
+/// Subscribe to reports of the engine's searches.
+/// A report is sent after every completed iteration of iterative deepening, and additionally every
+/// `interval` milliseconds while an iteration is in progress if the interval is nonzero.
+/// \param callback Function receiving every report, or NULL to stop reporting
+/// \param data User data passed to the callback
+/// \param interval Minimum number of milliseconds between periodic reports, or 0 to disable them
+void max_engine_set_info(max_engine_t *engine, max_search_info_fn callback, void *data, uint32_t interval);
+
+/// Set the number of principal variations searched by every iteration, each beginning with a different root move.
+/// The best move is searched first, then every following line searches the root moves that no previous line began
+/// with. All lines share the transposition table and move ordering of the search, so searching `count` lines is far
+/// cheaper than `count` independent searches.
+/// \param count Number of lines, clamped between 1 and #MAX_ENGINE_MULTIPV_MAX
+void max_engine_set_multipv(max_engine_t *engine, uint8_t count);
+
 /// Attempt to locate the best move for the current side to play with iterative deepening.
 /// \param [in] engine The engine containing the currently analyzed chess board
+/// \param [in] limits Conditions under which the search will stop
 /// \param [out] search Pointer to an uninitialized search result theat will be filled with the result of the search.
-void max_engine_search(max_engine_t *engine, max_search_result_t *search);
+void max_engine_search(max_engine_t *engine, max_search_limits_t const *limits, max_search_result_t *search);
+
+/// Request that the running search stops as soon as possible.
+/// This only raises a flag. With MAX_THREADS it may be called from any thread, while otherwise the flag is only
+/// volatile and should be raised from the search's info callback or a signal handler.
+/// The search notices the flag within #MAX_ENGINE_POLL_INTERVAL interior-node move iterations, and reports the time
+/// it took to stop in max_search_result_t::stop_latency.
+void max_engine_stop(max_engine_t *engine);
+
+/// Get the progress of a running search, which may be called from any thread with MAX_THREADS, or otherwise from the
+/// search's info callback
+max_search_progress_t max_engine_progress(max_engine_t *engine);
+
+#ifdef MAX_THREADS
+
+/// Begin searching the engine's board on a new thread, returning immediately.
+/// The board must not be modified until the search has been joined with max_engine_search_wait().
+///
+/// When pondering, the board should hold the position after the opponent's expected reply.
+/// The search then ignores its time limits until max_engine_ponderhit() is called when the opponent plays the
+/// expected move, and will not finish on its own before that. If the opponent plays a different move,
+/// the ponder search is abandoned with max_engine_stop() and max_engine_search_wait().
+/// \param limits Limits of the search, with time allocated from the moment of a ponder hit when pondering
+/// \param ponder true to begin a ponder search
+/// \return false if the search thread could not be created
+bool max_engine_search_start(max_engine_t *engine, max_search_limits_t const *limits, bool ponder);
+
+/// Check if a search started by max_engine_search_start() has finished, without blocking
+bool max_engine_search_done(max_engine_t *engine);
+
+/// Wait for a search started by max_engine_search_start() to finish and join its thread
+/// \param [out] search Filled with the result of the search
+void max_engine_search_wait(max_engine_t *engine, max_search_result_t *search);
+
+/// Convert a running ponder search into a normal search after the opponent played the expected move.
+/// Time limits are applied from the moment this is called, and the search keeps everything it has found so far.
+void max_engine_ponderhit(max_engine_t *engine);
+
+#endif
 
 /// @}
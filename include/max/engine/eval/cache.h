@@ -0,0 +1,39 @@
+/// \file cache.h
+#pragma once
+
+#include "max/board/zobrist.h"
+#include "max/def.h"
+#include "max/engine/score.h"
+
+/// \ingroup eval
+/// @{
+
+/// \defgroup evalcache Evaluation Cache
+/// Static evaluations are requested repeatedly for the same position, once by the frontier pruning of a node and again
+/// by the quiescence search below it, and for every transposition that reaches a position the transposition table
+/// could not cut off.
+/// The most recent evaluations are kept in a small direct-mapped cache indexed by the zobrist key of the position.
+/// @{
+
+/// Number of bits of the position key used to index the evaluation cache
+#define MAX_ENGINE_EVALCACHE_NBIT (12)
+
+/// Number of entries in a #max_evalcache_t
+#define MAX_ENGINE_EVALCACHE_LEN (1 << MAX_ENGINE_EVALCACHE_NBIT)
+
+/// A single cached static evaluation
+typedef struct {
+    /// Zobrist key of the evaluated position, including the side to play
+    max_zobrist_t key;
+    /// Static evaluation of the position from the perspective of the side to play
+    max_score_t score;
+} max_evalentry_t;
+
+/// Direct-mapped cache of static evaluations that always replaces the entry in the slot of a new position
+typedef struct {
+    max_evalentry_t buf[MAX_ENGINE_EVALCACHE_LEN];
+} max_evalcache_t;
+
+/// @}
+
+/// @}
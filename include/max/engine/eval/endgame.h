@@ -0,0 +1,67 @@
+/// \file endgame.h
+#pragma once
+
+#include "max/board/board.h"
+#include "max/board/psqt.h"
+#include "max/board/side.h"
+#include "max/board/zobrist.h"
+#include "max/def.h"
+#include "max/engine/score.h"
+#include <stdint.h>
+
+/// \ingroup eval
+/// @{
+
+/// \defgroup endgame Material Table and Endgames
+/// Terms that depend only on the number of pieces of each type are computed once per material balance and cached in a
+/// table indexed by the material key of the board, see max_state_t::material.
+/// The same lookup recognizes endgames that the general evaluation scores poorly - positions that are won but
+/// require a long sequence of quiet moves to make progress, and positions that are drawn despite a material advantage.
+/// @{
+
+/// Number of bits of the material key used to index the material table
+#define MAX_ENGINE_MATERIALTBL_NBIT (9)
+
+/// Number of entries in a #max_materialtbl_t
+#define MAX_ENGINE_MATERIALTBL_LEN (1 << MAX_ENGINE_MATERIALTBL_NBIT)
+
+/// Base score given by endgame evaluators to positions that are won with correct play
+#define MAX_ENDGAME_KNOWN_WIN (2000)
+
+/// Scale factor that leaves the general evaluation unchanged, see #max_endgame_scale_fn
+#define MAX_ENDGAME_SCALE_NORMAL (64)
+
+/// An evaluator for a specific endgame replacing the general evaluation.
+/// \param [in] board Board with the material balance that the evaluator was selected for
+/// \param strong Side with the material advantage
+/// \return Score of the position from the perspective of the strong side
+typedef max_score_t (*max_endgame_eval_fn)(max_board_t *board, max_side_t strong);
+
+/// A function that reduces the general evaluation of an endgame that is more drawish than its material suggests.
+/// \param [in] board Board with the material balance that the function was selected for
+/// \return Factor out of #MAX_ENDGAME_SCALE_NORMAL to multiply the general evaluation by
+typedef uint8_t (*max_endgame_scale_fn)(max_board_t *board);
+
+/// Evaluation terms of a single material balance
+typedef struct {
+    /// Material key of the balance this entry was computed for
+    max_zobrist_t key;
+    /// Imbalance adjustments from white's perspective
+    max_phasescore_t imbalance;
+    /// Evaluator that replaces the general evaluation, or NULL if the balance has no specialized evaluator
+    max_endgame_eval_fn eval;
+    /// Function that scales the general evaluation, or NULL if the evaluation is not scaled
+    max_endgame_scale_fn scale;
+    /// Side with the material advantage, passed to #eval
+    max_side_t strong;
+} max_materialentry_t;
+
+/// Direct-mapped table of material balance evaluations indexed by the low bits of the material key, where a new
+/// balance always replaces the entry in its slot
+typedef struct {
+    max_materialentry_t buf[MAX_ENGINE_MATERIALTBL_LEN];
+} max_materialtbl_t;
+
+/// @}
+
+/// @}
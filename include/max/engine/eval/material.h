@@ -3,6 +3,7 @@
 
 
 #include "max/board/piecelist.h"
+#include "max/board/psqt.h"
 #include "max/def.h"
 #include "max/engine/score.h"
 
@@ -40,6 +41,28 @@ MAX_INLINE_ALWAYS max_engine_material_cfg_t max_engine_material_cfg_default(void
     };
 }
 
+/// Adjustments to the value of pieces that depend on the other material of the same side.
+typedef struct {
+    /// Bonus for a side that has two or more bishops
+    max_phasescore_t bishop_pair;
+    /// Adjustment to the value of each knight for every friendly pawn above five, as knights gain value in closed
+    /// positions
+    max_score_t knight_pawns;
+    /// Adjustment to the value of each rook for every friendly pawn above five, as rooks lose value in closed
+    /// positions
+    max_score_t rook_pawns;
+} max_engine_imbalance_param_t;
+
+/// Get sensible default values for material imbalance adjustments.
+/// \return #max_engine_imbalance_param_t
+MAX_INLINE_ALWAYS max_engine_imbalance_param_t max_engine_imbalance_param_default(void) {
+    return (max_engine_imbalance_param_t){
+        .bishop_pair = { 30, 50 },
+        .knight_pawns = 6,
+        .rook_pawns = -12,
+    };
+}
+
 /// Get a value for raw material for the given side measured by the engine's configured piece material scores.
 /// \param [in] material Pointer to a structure with configured material scores for each piece type
 /// \param [in] pieces A collection of piece lists for each chess piece type
@@ -3,6 +3,7 @@
 
 
 #include "max/engine/eval/material.h"
+#include "max/engine/eval/prune.h"
 #include "max/engine/eval/pstbl.h"
 #include "max/engine/eval/strategy.h"
 
@@ -14,11 +15,15 @@ typedef struct {
     /// Scores assigned to each piece type that provide the majority of evaluation, the rest augments this to
     /// discriminate between more equal positions only separated by more strategic analysis.
     max_engine_material_cfg_t material;
+    /// Adjustments to material values by the combination of pieces that a side has
+    max_engine_imbalance_param_t imbalance;
     /// Piece-square tables for the mid and endgame that encourage basic positional play by scoring certain squares
     /// higher.
     max_engine_psqt_param_t position;
     /// Scores assigned to more complex analysis
     max_engine_strat_param_t strategy;
+    /// Margins of the static evaluation used to prune frontier nodes of the search
+    max_engine_prune_param_t prune;
 } max_eval_params_t;
 
 /// Get sensible defaults for all evaluation parameters.
@@ -28,8 +33,10 @@ typedef struct {
 MAX_INLINE_ALWAYS max_eval_params_t max_eval_params_default(void) {
     return (max_eval_params_t){
         .material = max_engine_material_cfg_default(),
+        .imbalance = max_engine_imbalance_param_default(),
         .position = max_engine_psqt_param_default(),
         .strategy = max_engine_strat_param_default(),
+        .prune = max_engine_prune_param_default(),
     };
 }
 
@@ -0,0 +1,50 @@
+/// \file pawns.h
+#pragma once
+
+#include "max/board/psqt.h"
+#include "max/board/side.h"
+#include "max/board/zobrist.h"
+#include "max/def.h"
+#include <stdint.h>
+
+/// \ingroup eval
+/// @{
+
+/// \defgroup pawns Pawn Structure
+/// Pawns move rarely and never backwards, so the same pawn structure is reached by a huge number of positions in a
+/// search tree.
+/// Terms that depend only on the placement of pawns are computed once per pawn structure and cached in a table indexed
+/// by the pawn zobrist key of the board, see max_state_t::pawns.
+/// @{
+
+/// Number of bits of the pawn key used to index the pawn structure table
+#define MAX_ENGINE_PAWNTBL_NBIT (10)
+
+/// Number of entries in a #max_pawntbl_t
+#define MAX_ENGINE_PAWNTBL_LEN (1 << MAX_ENGINE_PAWNTBL_NBIT)
+
+/// Evaluation of a single pawn structure.
+/// Squares and files are stored as seen from white, with files indexed from the A file and ranks from the first rank.
+typedef struct {
+    /// Pawn key of the structure this entry was computed for
+    max_zobrist_t key;
+    /// Score of passed, isolated, doubled, and backward pawns from white's perspective
+    max_phasescore_t score;
+    /// Squares on the opponent's half of the board for each side that are protected by a friendly pawn and can never
+    /// be attacked by an enemy pawn, indexed by #max_6bit_t
+    uint64_t outposts[MAX_SIDES_LEN];
+    /// Rank masks for each side and file of the squares that the side's pawns attack or may attack after advancing
+    uint8_t spans[MAX_SIDES_LEN][8];
+    /// Mask of the files containing a passed pawn for each side
+    uint8_t passed[MAX_SIDES_LEN];
+} max_pawnentry_t;
+
+/// Direct-mapped table of pawn structure evaluations indexed by the low bits of the pawn key, where a new structure
+/// always replaces the entry in its slot
+typedef struct {
+    max_pawnentry_t buf[MAX_ENGINE_PAWNTBL_LEN];
+} max_pawntbl_t;
+
+/// @}
+
+/// @}
@@ -0,0 +1,46 @@
+/// \file prune.h
+#pragma once
+
+#include "max/def.h"
+#include "max/engine/score.h"
+
+/// \ingroup eval
+/// @{
+
+/// \defgroup prune Static Pruning Margins
+/// Margins applied to the static evaluation of frontier nodes to decide if they can be pruned without searching
+/// every move.
+/// @{
+
+/// Greatest remaining depth at which a node may be pruned by its static evaluation
+#define MAX_ENGINE_PRUNE_DEPTH (3)
+
+/// Margins in centipawns indexed by the remaining depth of a node, with the entry for depth 0 unused
+typedef max_score_t max_engine_prune_margins_t[MAX_ENGINE_PRUNE_DEPTH + 1];
+
+/// Parameters for pruning frontier nodes of a zero window search by their static evaluation
+typedef struct {
+    /// Reverse futility: a node whose static evaluation beats beta by this margin is expected to fail high even
+    /// after the opponent's best reply, and returns its evaluation without searching any move
+    max_engine_prune_margins_t reverse_futility;
+    /// Futility: when the static evaluation plus this margin cannot reach alpha, quiet moves that do not give check
+    /// are skipped after the first move, as they are not expected to recover the material deficit
+    max_engine_prune_margins_t futility;
+    /// Razoring: when the static evaluation plus this margin cannot reach alpha, the node is verified by quiescence
+    /// search and returns immediately if that also fails low
+    max_engine_prune_margins_t razor;
+} max_engine_prune_param_t;
+
+/// Get default margins for static pruning
+/// \return Default pruning margins
+MAX_INLINE_ALWAYS max_engine_prune_param_t max_engine_prune_param_default(void) {
+    return (max_engine_prune_param_t){
+        .reverse_futility = { 0, 120, 240, 360 },
+        .futility = { 0, 200, 300, 500 },
+        .razor = { 0, 300, 450, 600 },
+    };
+}
+
+/// @}
+
+/// @}
@@ -2,8 +2,11 @@
 #pragma once
 
 #include "max/board/loc.h"
+#include "max/board/piececode.h"
+#include "max/board/side.h"
 #include "max/def.h"
 #include "max/engine/score.h"
+#include <stdint.h>
 
 /// \ingroup eval
 /// @{
@@ -14,85 +17,196 @@
 
 
 /// A piece-square table mapping a chess position to a score.
-/// Stored with packed 6 bit indices to reduce the memory requirements of table lookups.
+/// Tables are written as seen from white's side of the board, with the eighth rank on the first row, and are indexed
+/// by max_pstbl_index().
 /// \see #max_engine_psqt_param_t
-typedef max_smallscore_t max_pstbl_t[MAX_6BIT_LEN];
+typedef max_score_t max_pstbl_t[MAX_6BIT_LEN];
+
+/// Piece-square tables for each piece type, used for a single phase of the game.
+/// Data can be indexed by the name of the piece type or #max_pieceindex_t.
+typedef union {
+    struct {
+        max_pstbl_t pawn;
+        max_pstbl_t knight;
+        max_pstbl_t bishop;
+        max_pstbl_t rook;
+        max_pstbl_t queen;
+        max_pstbl_t king;
+    };
+
+    max_pstbl_t array[MAX_PIECEINDEX_LEN];
+} max_engine_psqt_set_t;
+
+/// Weight of each piece type in the game phase.
+/// The phase of a position is the sum of the weights of all pieces on the board, so that it decreases towards zero
+/// as pieces are traded off.
+typedef union {
+    struct {
+        uint8_t pawn;
+        uint8_t knight;
+        uint8_t bishop;
+        uint8_t rook;
+        uint8_t queen;
+    };
+
+    uint8_t array[MAX_PIECEINDEX_LEN];
+} max_engine_phase_cfg_t;
 
 /// A collection of square score tables for each piece type used to provide basic position
 /// evaluation in conjuction with more complex analysis.
+/// Positions are scored by both the midgame and endgame tables, and the final score is interpolated between the two
+/// by the game phase.
 typedef struct {
-    max_pstbl_t pawn;
-    max_pstbl_t knight;
-    max_pstbl_t bishop;
-    max_pstbl_t rook;
-    max_pstbl_t queen;
-    max_pstbl_t king;
+    /// Tables applied with full weight when all pieces are on the board
+    max_engine_psqt_set_t mg;
+    /// Tables applied with full weight when only pawns and kings remain
+    max_engine_psqt_set_t eg;
+    /// Weights of each piece type used to compute the game phase
+    max_engine_phase_cfg_t phase;
 } max_engine_psqt_param_t;
 
-/// Get a default #max_position_param_t with tables that encourage midgame pawn advancement and knight centering.
-/// \return #max_position_param_t with default values
+/// Get the index into a #max_pstbl_t of a piece of the given side on the given square.
+/// White pieces are mirrored to match the layout of the tables, while black pieces read the table upside down.
+MAX_INLINE_ALWAYS max_6bit_t max_pstbl_index(max_0x88_t pos, max_side_t side) {
+    return max_0x88_to_6bit(max_0x88_mirror_side(pos, side ^ 1));
+}
+
+/// Get a default #max_engine_psqt_param_t with midgame tables that encourage pawn advancement, knight centering,
+/// and king safety, and endgame tables that encourage pushing passed pawns and centralizing the king.
+/// \return #max_engine_psqt_param_t with default values
 MAX_INLINE_ALWAYS max_engine_psqt_param_t max_engine_psqt_param_default(void) {
     return (max_engine_psqt_param_t){
-        .pawn = {
-             0,  0,  0,  0,  0,  0,  0,  0,
-            50, 50, 50, 50, 50, 50, 50, 50,
-            10, 10, 20, 30, 30, 20, 10, 10,
-             5,  5, 10, 25, 25, 10,  5,  5,
-             0,  0,  0, 20, 20,  0,  0,  0,
-             5, -5,-10,  0,  0,-10, -5,  5,
-             5, 10, 10,-20,-20, 10, 10,  5,
-             0,  0,  0,  0,  0,  0,  0,  0
-        },
-        .knight = {
-            -50,-40,-30,-30,-30,-30,-40,-50,
-            -40,-20,  0,  0,  0,  0,-20,-40,
-            -30,  0, 10, 15, 15, 10,  0,-30,
-            -30,  5, 15, 20, 20, 15,  5,-30,
-            -30,  0, 15, 20, 20, 15,  0,-30,
-            -30,  5, 10, 15, 15, 10,  5,-30,
-            -40,-20,  0,  5,  5,  0,-20,-40,
-            -50,-40,-30,-30,-30,-30,-40,-50,
-        },
-        .bishop = {
-            -20,-10,-10,-10,-10,-10,-10,-20,
-            -10,  0,  0,  0,  0,  0,  0,-10,
-            -10,  0,  5, 10, 10,  5,  0,-10,
-            -10,  5,  5, 10, 10,  5,  5,-10,
-            -10,  0, 10, 10, 10, 10,  0,-10,
-            -10, 10, 10, 10, 10, 10, 10,-10,
-            -10,  5,  0,  0,  0,  0,  5,-10,
-            -20,-10,-10,-10,-10,-10,-10,-20,
+        .mg = {
+            .pawn = {
+                 0,  0,  0,  0,  0,  0,  0,  0,
+                50, 50, 50, 50, 50, 50, 50, 50,
+                10, 10, 20, 30, 30, 20, 10, 10,
+                 5,  5, 10, 25, 25, 10,  5,  5,
+                 0,  0,  0, 20, 20,  0,  0,  0,
+                 5, -5,-10,  0,  0,-10, -5,  5,
+                 5, 10, 10,-20,-20, 10, 10,  5,
+                 0,  0,  0,  0,  0,  0,  0,  0
+            },
+            .knight = {
+                -50,-40,-30,-30,-30,-30,-40,-50,
+                -40,-20,  0,  0,  0,  0,-20,-40,
+                -30,  0, 10, 15, 15, 10,  0,-30,
+                -30,  5, 15, 20, 20, 15,  5,-30,
+                -30,  0, 15, 20, 20, 15,  0,-30,
+                -30,  5, 10, 15, 15, 10,  5,-30,
+                -40,-20,  0,  5,  5,  0,-20,-40,
+                -50,-40,-30,-30,-30,-30,-40,-50,
+            },
+            .bishop = {
+                -20,-10,-10,-10,-10,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5, 10, 10,  5,  0,-10,
+                -10,  5,  5, 10, 10,  5,  5,-10,
+                -10,  0, 10, 10, 10, 10,  0,-10,
+                -10, 10, 10, 10, 10, 10, 10,-10,
+                -10,  5,  0,  0,  0,  0,  5,-10,
+                -20,-10,-10,-10,-10,-10,-10,-20,
+            },
+            .rook = {
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  5, 10, 10, 10, 10, 10, 10,  5,
+                 -5,  0,  0,  0,  0,  0,  0, -5,
+                 -5,  0,  0,  0,  0,  0,  0, -5,
+                 -5,  0,  0,  0,  0,  0,  0, -5,
+                 -5,  0,  0,  0,  0,  0,  0, -5,
+                 -5,  0,  0,  0,  0,  0,  0, -5,
+                  0,  0,  0,  5,  5,  0,  0,  0
+            },
+            .queen = {
+                -20,-10,-10, -5, -5,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5,  5,  5,  5,  0,-10,
+                 -5,  0,  5,  5,  5,  5,  0, -5,
+                  0,  0,  5,  5,  5,  5,  0, -5,
+                -10,  5,  5,  5,  5,  5,  0,-10,
+                -10,  0,  5,  0,  0,  0,  0,-10,
+                -20,-10,-10, -5, -5,-10,-10,-20
+            },
+            .king = {
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -30,-40,-40,-50,-50,-40,-40,-30,
+                -20,-30,-30,-40,-40,-30,-30,-20,
+                -10,-20,-20,-20,-20,-20,-20,-10,
+                 20, 20,  0,  0,  0,  0, 20, 20,
+                 20, 30, 10,  0,  0, 10, 30, 20
+            },
         },
-        .rook = {
-              0,  0,  0,  0,  0,  0,  0,  0,
-              5, 10, 10, 10, 10, 10, 10,  5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-              0,  0,  0,  5,  5,  0,  0,  0
+        .eg = {
+            .pawn = {
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                 90, 90, 90, 90, 90, 90, 90, 90,
+                 60, 60, 60, 60, 60, 60, 60, 60,
+                 35, 35, 35, 35, 35, 35, 35, 35,
+                 20, 20, 20, 20, 20, 20, 20, 20,
+                 10, 10, 10, 10, 10, 10, 10, 10,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0
+            },
+            .knight = {
+                -50,-40,-30,-30,-30,-30,-40,-50,
+                -40,-20,  0,  0,  0,  0,-20,-40,
+                -30,  0, 10, 15, 15, 10,  0,-30,
+                -30,  5, 15, 20, 20, 15,  5,-30,
+                -30,  0, 15, 20, 20, 15,  0,-30,
+                -30,  5, 10, 15, 15, 10,  5,-30,
+                -40,-20,  0,  5,  5,  0,-20,-40,
+                -50,-40,-30,-30,-30,-30,-40,-50,
+            },
+            .bishop = {
+                -20,-10,-10,-10,-10,-10,-10,-20,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -10,  0,  5, 10, 10,  5,  0,-10,
+                -10,  5, 10, 10, 10, 10,  5,-10,
+                -10,  5, 10, 10, 10, 10,  5,-10,
+                -10,  0,  5, 10, 10,  5,  0,-10,
+                -10,  0,  0,  0,  0,  0,  0,-10,
+                -20,-10,-10,-10,-10,-10,-10,-20,
+            },
+            .rook = {
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                 10, 10, 10, 10, 10, 10, 10, 10,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0,
+                  0,  0,  0,  0,  0,  0,  0,  0
+            },
+            .queen = {
+                -20,-10,-10, -5, -5,-10,-10,-20,
+                -10,  0,  5,  5,  5,  5,  0,-10,
+                -10,  5, 10, 10, 10, 10,  5,-10,
+                 -5,  5, 10, 15, 15, 10,  5, -5,
+                 -5,  5, 10, 15, 15, 10,  5, -5,
+                -10,  5, 10, 10, 10, 10,  5,-10,
+                -10,  0,  5,  5,  5,  5,  0,-10,
+                -20,-10,-10, -5, -5,-10,-10,-20
+            },
+            .king = {
+                -50,-40,-30,-20,-20,-30,-40,-50,
+                -30,-20,-10,  0,  0,-10,-20,-30,
+                -30,-10, 20, 30, 30, 20,-10,-30,
+                -30,-10, 30, 40, 40, 30,-10,-30,
+                -30,-10, 30, 40, 40, 30,-10,-30,
+                -30,-10, 20, 30, 30, 20,-10,-30,
+                -30,-30,  0,  0,  0,  0,-30,-30,
+                -50,-30,-30,-30,-30,-30,-30,-50
+            },
         },
-        .queen = {
-            -20,-10,-10, -5, -5,-10,-10,-20,
-            -10,  0,  0,  0,  0,  0,  0,-10,
-            -10,  0,  5,  5,  5,  5,  0,-10,
-             -5,  0,  5,  5,  5,  5,  0, -5,
-              0,  0,  5,  5,  5,  5,  0, -5,
-            -10,  5,  5,  5,  5,  5,  0,-10,
-            -10,  0,  5,  0,  0,  0,  0,-10,
-            -20,-10,-10, -5, -5,-10,-10,-20
+        .phase = {
+            .pawn = 0,
+            .knight = 1,
+            .bishop = 1,
+            .rook = 2,
+            .queen = 4,
         },
-        .king = {
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -20,-30,-30,-40,-40,-30,-30,-20,
-            -10,-20,-20,-20,-20,-20,-20,-10,
-             20, 20,  0,  0,  0,  0, 20, 20,
-             20, 30, 10,  0,  0, 10, 30, 20
-        }
     };
 }
 
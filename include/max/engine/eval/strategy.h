@@ -1,6 +1,6 @@
 /// \file strategy.h
 #pragma once
-#include "max/board/board.h"
+#include "max/board/psqt.h"
 #include "max/def.h"
 #include "max/engine/score.h"
 
@@ -8,36 +8,36 @@
 /// @{
 
 /// \defgroup strat Strategic Evaluation
-/// More complex analysis identifying strategies like placement on outpost squares
+/// More complex analysis identifying strategies like placement on outpost squares and pawn structure
 /// @{
 
 /// Parameters for engine evaluation of strategic play
 typedef struct {
     /// Bonus for knights and rooks placed on outpost squares
     max_score_t outpost;
+    /// Bonus for a pawn with no enemy pawns in front of it on its own or adjacent files, indexed by its rank as seen
+    /// from its own side
+    max_phasescore_t passed[8];
+    /// Penalty for a pawn with no friendly pawns on adjacent files
+    max_phasescore_t isolated;
+    /// Penalty for each pawn standing behind another friendly pawn on the same file
+    max_phasescore_t doubled;
+    /// Penalty for a pawn that has fallen behind the pawns on adjacent files and cannot advance without being
+    /// captured by an enemy pawn
+    max_phasescore_t backward;
 } max_engine_strat_param_t;
 
-
-/// Check if a pawn attacks the given square or may attack the given square after advancing.
-/// \param [in] board The board to scan for attacking pawns
-/// \param sq Square to check for attacks along the file of
-/// \param enemy Color of the enemy's pieces
-/// \return The number of pawns that may advance and attack the given square
-max_score_t max_engine_pawn_attacks_span(max_board_t const *board, max_0x88_t sq, max_side_t enemy);
-
-/// Get an outpost bonus for the given square.
-/// \param outpost_bonus The score to return for an outpost square
-/// \param [in] board The board to scan for enemy and friendly pawns
-/// \param sq Square to check for outposting
-/// \param side The side of the piece on the outpost square
-/// \return The value of the outpost_bonus parameter
-max_score_t max_engine_outpost(max_score_t outpost_bonus, max_board_t const *board, max_0x88_t sq, max_side_t side);
-
 /// Get default values for all strategic evaluation scores.
 /// \return Default strategic evaluation scores
 MAX_INLINE_ALWAYS max_engine_strat_param_t max_engine_strat_param_default(void) {
     return (max_engine_strat_param_t){
-        .outpost = 142
+        .outpost = 142,
+        .passed = {
+            { 0, 0 }, { 5, 10 }, { 5, 15 }, { 10, 25 }, { 20, 45 }, { 35, 75 }, { 60, 110 }, { 0, 0 }
+        },
+        .isolated = { -10, -15 },
+        .doubled = { -10, -20 },
+        .backward = { -8, -10 },
     };
 }
 
@@ -21,6 +21,49 @@ typedef int16_t max_score_t;
 /// alpha-beta search.
 #define MAX_SCORE_LOWEST  (INT16_MIN + 1000)
 
+/// Lowest magnitude of the score given to a checkmate.
+/// Mate scores are offset above this value by the number of plies between the root and the mate that are not played,
+/// so that shorter mates are preferred.
+#define MAX_SCORE_MATE (20000)
+
+/// Number of plies from the root over which the distance to a mate is distinguished
+#define MAX_SCORE_MATE_PLIES (256)
+
+/// Check if the given score indicates that either side can force checkmate
+MAX_INLINE_ALWAYS bool max_score_is_mate(max_score_t score) {
+    return score >= MAX_SCORE_MATE || score <= -MAX_SCORE_MATE;
+}
+
+/// Get the score of the side to play being checkmated at the given distance in plies from the root of the search
+MAX_INLINE_ALWAYS max_score_t max_score_mated(uint8_t ply) {
+    return -(MAX_SCORE_MATE + MAX_SCORE_MATE_PLIES - 1 - ply);
+}
+
+/// Convert a mate score measured from the root of the search into one measured from a node at the given ply, so that
+/// it remains correct when the node is reached at a different ply through a transposition.
+/// Scores that are not mates are returned unchanged.
+MAX_INLINE_ALWAYS max_score_t max_score_to_node(max_score_t score, uint8_t ply) {
+    if(score >= MAX_SCORE_MATE) {
+        return score + ply;
+    } else if(score <= -MAX_SCORE_MATE) {
+        return score - ply;
+    }
+
+    return score;
+}
+
+/// Convert a mate score measured from a node at the given ply back into one measured from the root of the search,
+/// reversing max_score_to_node()
+MAX_INLINE_ALWAYS max_score_t max_score_from_node(max_score_t score, uint8_t ply) {
+    if(score >= MAX_SCORE_MATE) {
+        return score - ply;
+    } else if(score <= -MAX_SCORE_MATE) {
+        return score + ply;
+    }
+
+    return score;
+}
+
 /// A signed score in centipawns in the range [-128, 127].
 /// This is a compressed version of #max_score_t used to store piece-square tables and other lookup
 /// tables whose elements all value less than a pawn as compact as possible.
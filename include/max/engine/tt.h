@@ -1,6 +1,7 @@
 /// \file tt.h
 #pragma once
 #include "max/board/loc.h"
+#include "max/board/move.h"
 #include "max/board/zobrist.h"
 #include "max/def.h"
 #include "max/engine/score.h"
@@ -15,132 +16,183 @@
 /// speeding up game tree searches by eliminating already-searched portions of the tree.
 /// @{
 
-/// Key portion of a zobrist hash, created after masking away the lower index bits.
-/// This is half the size of a true zobrist hash to aggresively reduce the size of the transposition table,
-/// at the cost of increased table collision rate if the key portion is actually larger than the storage type.
-/// @{
-
-#ifdef MAX_ZOBRIST_64
-typedef uint32_t max_ttentry_key_t;
-#else
-typedef uint16_t max_ttentry_key_t;
-#endif
-
-/// @}
-
-/// Packed attributes for a #max_ttentry_t, including the best move's from and to square,
-/// the kind of node stored, and depth that the node was searched to.
+/// Packed contents of a #max_ttentry_t, including the full best move with its source and destination squares
+/// and move tag, the kind of node stored, the depth that the node was searched to, the search generation that
+/// created the entry, and the node's score.
 /// ## Bit Layout
 /// ```
-/// [ 2 bits - node kind ][ 2 bits - depth ][6 bits - destination square][ 6 bits - source square ]
+/// [8 bits - unused][8 bits - move tag][16 bits - score][8 bits - generation][8 bits - depth][2 bits - unused][2 bits - node kind][6 bits - destination square][6 bits - source square]
 /// ```
-typedef uint16_t max_ttentry_pattr_t;
+typedef uint64_t max_ttentry_data_t;
 
 enum {
-    /// Mask for the lowest 6 bits of a #max_ttentry_pattr_t to get the packed move source square
-    MAX_TTENTRY_PATTR_SOURCE_MASK = 0x003F,
-    /// Mask for bits [11, 6] of a #max_ttentry_pattr_t to get the packed move destination square
-    MAX_TTENTRY_PATTR_DEST_MASK   = 0x0FC0,
+    /// Mask for the lowest 6 bits of a #max_ttentry_data_t to get the packed move source square
+    MAX_TTENTRY_DATA_SOURCE_MASK = 0x3F,
+    /// Mask for the 6 destination square bits after shifting by #MAX_TTENTRY_DATA_DEST_POS
+    MAX_TTENTRY_DATA_DEST_MASK   = 0x3F,
     /// Bit offset from the LSB that the 6 destination square bits are located at
-    MAX_TTENTRY_PATTR_DEST_POS    = 6,
-    /// Mask for bits [13, 12] of a #max_ttentry_pattr_t for the two depth bits
-    MAX_TTENTRY_PATTR_DEPTH_MASK  = 0x3000,
-    /// Bit offset from the LSB that the two depth bits are located
-    MAX_TTENTRY_PATTR_DEPTH_POS   = 12,
-    /// Bitmask for the upper 2 bits [15, 14] of a #max_ttentry_pattr_t containing the node kind
-    MAX_TTENTRY_PATTR_KIND_MASK   = 0xC000,
-    /// Bit offset from the LSB that the two node kind bits are located
-    MAX_TTENTRY_PATTR_KIND_POS    = 14,
+    MAX_TTENTRY_DATA_DEST_POS    = 6,
+    /// Mask for the two node kind bits after shifting by #MAX_TTENTRY_DATA_KIND_POS
+    MAX_TTENTRY_DATA_KIND_MASK   = 0x03,
+    /// Bit offset from the LSB that the two node kind bits are located at
+    MAX_TTENTRY_DATA_KIND_POS    = 12,
+    /// Mask for the depth byte after shifting by #MAX_TTENTRY_DATA_DEPTH_POS
+    MAX_TTENTRY_DATA_DEPTH_MASK  = 0xFF,
+    /// Bit offset from the LSB that the depth byte is located at
+    MAX_TTENTRY_DATA_DEPTH_POS   = 16,
+    /// Mask for the generation byte after shifting by #MAX_TTENTRY_DATA_GENERATION_POS
+    MAX_TTENTRY_DATA_GENERATION_MASK = 0xFF,
+    /// Bit offset from the LSB that the generation byte is located at
+    MAX_TTENTRY_DATA_GENERATION_POS  = 24,
+    /// Mask for the 16 score bits after shifting by #MAX_TTENTRY_DATA_SCORE_POS
+    MAX_TTENTRY_DATA_SCORE_MASK  = 0xFFFF,
+    /// Bit offset from the LSB that the score bits are located at
+    MAX_TTENTRY_DATA_SCORE_POS   = 32,
+    /// Mask for the move tag byte after shifting by #MAX_TTENTRY_DATA_TAG_POS
+    MAX_TTENTRY_DATA_TAG_MASK    = 0xFF,
+    /// Bit offset from the LSB that the move tag byte is located at
+    MAX_TTENTRY_DATA_TAG_POS     = 48,
 };
 
-/// Create a new packed attribute from unpacked move source and destination squares,
-/// node kind specifier, and node analysis depth.
-MAX_INLINE_ALWAYS max_ttentry_pattr_t max_ttentry_pattr_new(
-    max_0x88_t from,
-    max_0x88_t to,
-    max_nodekind_t kind,
-    uint8_t depth
-) {
-    return 
-        max_0x88_to_6bit(from).v |
-        (max_0x88_to_6bit(to).v << MAX_TTENTRY_PATTR_DEST_POS) |
-        (kind << MAX_TTENTRY_PATTR_KIND_POS) |
-        (((depth + 1) >> 1) << MAX_TTENTRY_PATTR_DEPTH_POS);
+/// Pack a node score and the generation of the search that produced it into the data word of a #max_ttentry_t.
+MAX_INLINE_ALWAYS max_ttentry_data_t max_ttentry_data_new(max_nodescore_t score, uint8_t generation) {
+    return
+        ((max_ttentry_data_t)max_0x88_to_6bit(score.bestmove.from).v & MAX_TTENTRY_DATA_SOURCE_MASK) |
+        (((max_ttentry_data_t)max_0x88_to_6bit(score.bestmove.to).v & MAX_TTENTRY_DATA_DEST_MASK) << MAX_TTENTRY_DATA_DEST_POS) |
+        ((max_ttentry_data_t)(score.kind & MAX_TTENTRY_DATA_KIND_MASK) << MAX_TTENTRY_DATA_KIND_POS) |
+        ((max_ttentry_data_t)score.depth << MAX_TTENTRY_DATA_DEPTH_POS) |
+        ((max_ttentry_data_t)generation << MAX_TTENTRY_DATA_GENERATION_POS) |
+        ((max_ttentry_data_t)(uint16_t)score.score << MAX_TTENTRY_DATA_SCORE_POS) |
+        ((max_ttentry_data_t)score.bestmove.tag << MAX_TTENTRY_DATA_TAG_POS);
 }
 
-/// Get the 0x88 source square packed into a #max_ttentry_pattr_t
-MAX_INLINE_ALWAYS max_0x88_t max_ttentry_pattr_source(max_ttentry_pattr_t packed) {
-    return max_6bit_to_0x88(
-        max_6bit_raw(packed & MAX_TTENTRY_PATTR_SOURCE_MASK)
+/// Get the best or refutation move packed into a #max_ttentry_data_t.
+/// If no best move was found for the stored node, the move will be a placeholder that satisfies max_smove_is_none().
+/// The move was pseudo-legal in the position that produced the entry, but must be validated before it is played
+/// because a different position may have produced the entry with an identical hash.
+MAX_INLINE_ALWAYS max_smove_t max_ttentry_data_move(max_ttentry_data_t data) {
+    return max_smove_new(
+        max_6bit_to_0x88(max_6bit_raw(data & MAX_TTENTRY_DATA_SOURCE_MASK)),
+        max_6bit_to_0x88(max_6bit_raw((data >> MAX_TTENTRY_DATA_DEST_POS) & MAX_TTENTRY_DATA_DEST_MASK)),
+        (data >> MAX_TTENTRY_DATA_TAG_POS) & MAX_TTENTRY_DATA_TAG_MASK
     );
 }
 
-/// Get the 0x88 destination square packed into a #max_ttentry_pattr_t
-MAX_INLINE_ALWAYS max_0x88_t max_ttentry_pattr_dest(max_ttentry_pattr_t packed) {
-    return max_6bit_to_0x88(
-        max_6bit_raw((packed & MAX_TTENTRY_PATTR_DEST_MASK) >> MAX_TTENTRY_PATTR_DEST_POS)
-    );
+/// Get the kind of node packed into a #max_ttentry_data_t
+MAX_INLINE_ALWAYS max_nodekind_t max_ttentry_data_kind(max_ttentry_data_t data) {
+    return (data >> MAX_TTENTRY_DATA_KIND_POS) & MAX_TTENTRY_DATA_KIND_MASK;
 }
 
-/// Get the depth packed into the given tranposition table entry attributes.
-MAX_INLINE_ALWAYS uint8_t max_ttentry_pattr_depth(max_ttentry_pattr_t packed) {
-    return ((packed & MAX_TTENTRY_PATTR_DEPTH_MASK) >> MAX_TTENTRY_PATTR_DEPTH_POS) << 1;
+/// Get the depth that the node stored in a #max_ttentry_data_t was searched to
+MAX_INLINE_ALWAYS uint8_t max_ttentry_data_depth(max_ttentry_data_t data) {
+    return (data >> MAX_TTENTRY_DATA_DEPTH_POS) & MAX_TTENTRY_DATA_DEPTH_MASK;
 }
 
+/// Get the generation of the search that created the given #max_ttentry_data_t
+MAX_INLINE_ALWAYS uint8_t max_ttentry_data_generation(max_ttentry_data_t data) {
+    return (data >> MAX_TTENTRY_DATA_GENERATION_POS) & MAX_TTENTRY_DATA_GENERATION_MASK;
+}
 
-#pragma pack(push, 1)
+/// Get the score packed into a #max_ttentry_data_t
+MAX_INLINE_ALWAYS max_score_t max_ttentry_data_score(max_ttentry_data_t data) {
+    return (max_score_t)(uint16_t)((data >> MAX_TTENTRY_DATA_SCORE_POS) & MAX_TTENTRY_DATA_SCORE_MASK);
+}
+
+/// A single word of a #max_ttentry_t.
+/// When multiple threads are enabled, every word is read and written atomically with relaxed ordering
+/// so that concurrent searchers never observe half of a word, but may still observe the two words of an
+/// entry from different writes.
+/// @{
+
+#ifdef MAX_THREADS
+typedef _Atomic uint64_t max_ttentry_word_t;
+#else
+typedef uint64_t max_ttentry_word_t;
+#endif
+
+/// @}
 
 /// An entry in the transposition table containing the result of a prior evaluation.
 /// The size of this entry has massive effects on the memory footprint of the program as the transposition table
-/// should be the largest object in the engine, so reducing it's size is extremely important.
-/// It represents a best or refutation move in as compact a form as possible to reflect this, and packs all attributes into
-/// as few bits as possible.
+/// should be the largest object in the engine, so all attributes are packed into a single data word.
+///
+/// Entries are lock-free: the key word stores the zobrist hash XORed with the data word.
+/// A reader loads both words and accepts the entry only if XORing them reproduces the probed hash, so an entry
+/// torn by two writers racing on the same slot is detected and rejected instead of being trusted.
 typedef struct {
-    /// Key portin of the zobrist hash used to access this position, used to ensure that all index
-    /// collisions do not also result in a full hash collision, which would case the engine to use
-    /// invalid transposition table entries far more often.
-    max_ttentry_key_t key;
-    /// Score of the node as determined by the search when this entry was created.
-    /// If the node was alpha or beta cutoff, this is the value that caused the cutoff.
-    max_score_t score;
-    /// Packed attributes including the best or refutation move's source and destination squares, and
-    /// the kind of node score and depth that the node was searched to.
-    max_ttentry_pattr_t attr;
-
-    uint8_t age;
-    uint8_t depth;
+    /// Zobrist hash of the position XORed with #data.
+    /// Used to detect both index collisions between different positions and torn writes.
+    max_ttentry_word_t key;
+    /// Packed score, node kind, depth, generation, and best or refutation move of the stored node.
+    /// \see #max_ttentry_data_t
+    max_ttentry_word_t data;
 } max_ttentry_t;
 
-#pragma pack(pop)
+/// Size in bytes of a #max_ttbucket_t, chosen to match the cache line size of common processors
+#define MAX_TTBUCKET_SIZE (64)
+
+/// Number of entries stored in a single #max_ttbucket_t
+#define MAX_TTBUCKET_LEN (MAX_TTBUCKET_SIZE / sizeof(max_ttentry_t))
+
+/// A group of transposition table entries sharing one index, aligned to and filling a single cache line.
+/// A probe only ever touches one bucket, so looking up a position costs at most one cache miss no matter
+/// which of the bucket's entries holds it.
+/// Buffers of buckets must be allocated with an alignment of #MAX_TTBUCKET_SIZE.
+typedef struct {
+    _Alignas(MAX_TTBUCKET_SIZE) max_ttentry_t entries[MAX_TTBUCKET_LEN];
+} max_ttbucket_t;
 
 /// A transposition table of configurable power-of-two capacity.
 /// This table stores a pointer to the continuous buffer that will be used to store transposition table
-/// entries and the capacity of the buffer as a power of two.
+/// buckets and the capacity of the buffer as a power of two.
 typedef struct {
-    /// Pointer to the buffer that transposition table entries are stored to.
-    max_ttentry_t *buf;
-    /// Capacity of the buffer stored as a power of two.
-    /// Also used to create a bitmask that will separate the key and index parts of a zobrist hash.
+    /// Pointer to the buffer that transposition table buckets are stored to.
+    max_ttbucket_t *buf;
+    /// Capacity of the buffer in buckets stored as a power of two.
+    /// Also used to create a bitmask that will separate the index part of a zobrist hash.
     uint8_t nbit; 
+    /// Generation of the current search, stored in every inserted entry.
+    /// Entries from older generations are replaced before entries from the current search.
+    uint8_t generation;
 } max_ttbl_t;
 
 /// Get the index part of a zobrist hash according to the power-of-two capacity of the given tranposition table.
-/// \return an index into the table's buffer to be used to get the entry associated with the given hash
+/// \return an index into the table's buffer to be used to get the bucket associated with the given hash
 MAX_INLINE_ALWAYS uint32_t max_ttbl_get_index(max_ttbl_t *tbl, max_zobrist_t hash) {
     return hash & ((1 << tbl->nbit) - 1);
 }
 
-/// Get the key part of a zobrist hash used to detect index collisions in the tranposition table.
-MAX_INLINE_ALWAYS max_ttentry_key_t max_ttbl_get_key(max_ttbl_t *tbl, max_zobrist_t hash) {
-    return hash >> tbl->nbit;
+/// Hint to the processor that the bucket for the given position will soon be probed.
+/// This should be issued as early as the hash of a position is known so that the memory access overlaps
+/// with other work instead of stalling the later probe.
+MAX_INLINE_ALWAYS void max_ttbl_prefetch(max_ttbl_t *tbl, max_zobrist_t hash) {
+    MAX_PREFETCH(&tbl->buf[max_ttbl_get_index(tbl, hash)]);
 }
 
-/// Get a read-only pointer to the transposition table entry corresponding to a saved analysis of the given position.
-/// \return NULL if no entry was found corresponding to the zobrist hash, or a pointer to an entry that must only be read from.
-max_ttentry_t const* max_ttbl_probe_read(max_ttbl_t *tbl, max_zobrist_t hash);
+/// Begin a new search, marking all entries created by previous searches as older than new entries.
+MAX_INLINE_ALWAYS void max_ttbl_new_generation(max_ttbl_t *tbl) {
+    tbl->generation += 1;
+}
 
-/// Insert a new node score into the transposition table, potentially overwriting the previous stored score
-void max_ttbl_probe_insert(max_ttbl_t *tbl, max_zobrist_t hash, max_nodescore_t score, uint16_t ply);
+/// Read the transposition table entry corresponding to a saved analysis of the given position.
+/// This is safe to call while other threads insert into the same table.
+/// \param [out] data Filled with the packed contents of the entry if one was found
+/// \return false if no valid entry was found corresponding to the zobrist hash
+bool max_ttbl_probe_read(max_ttbl_t *tbl, max_zobrist_t hash, max_ttentry_data_t *data);
+
+/// Insert a new node score into the transposition table.
+/// If the position is already stored in its bucket, the stored entry is overwritten unless it was searched to
+/// a greater depth during the current search.
+/// Otherwise, the entry of the bucket that is least valuable by depth and generation is replaced.
+/// This is safe to call while other threads probe or insert into the same table.
+void max_ttbl_probe_insert(max_ttbl_t *tbl, max_zobrist_t hash, max_nodescore_t score);
+
+/// Number of entries sampled from the start of the table by max_ttbl_hashfull()
+#define MAX_TTBL_HASHFULL_SAMPLE (1000)
+
+/// Estimate how full the table is in permille by sampling the entries at the start of the table for entries written
+/// by the current search, as reported by the UCI `hashfull` field.
+uint16_t max_ttbl_hashfull(max_ttbl_t *tbl);
 
 /// @}
 
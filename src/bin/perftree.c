@@ -106,7 +106,7 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    max_board_movegen(&board, &user_moves);
+    max_board_movegen_legal(&board, &user_moves);
     
 
     max_movelist_t moves;
@@ -116,16 +116,14 @@ int main(int argc, char *argv[]) {
     for(unsigned i = 0; i < user_moves.len; ++i) {
         max_smove_t move = user_moves.buf[i];
 
-        if(max_board_legal(&board, move)) {
-            max_board_make_move(&board, move);
-            uint64_t nodes = max_board_perft(&board, moves, depth - 1);
-            max_board_unmake_move(&board, move);
-            
-            print_move(move);
-            printf(" %zu\n", nodes);
+        max_board_make_move(&board, move);
+        uint64_t nodes = max_board_perft(&board, moves, depth - 1);
+        max_board_unmake_move(&board, move);
+        
+        print_move(move);
+        printf(" %zu\n", nodes);
 
-            count += nodes;
-        }
+        count += nodes;
     }
 
     printf("\n%zu\n\n", count);
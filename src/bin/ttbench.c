@@ -0,0 +1,159 @@
+#include "max.h"
+#include "max/board/loc.h"
+#include "max/board/move.h"
+#include "max/engine/score.h"
+#include "max/engine/tt.h"
+#include "private/engine/tt.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#define MAX_BENCH_THREADS (64)
+
+/// State of a single benchmark thread hammering the shared table
+typedef struct {
+    max_ttbl_t *tbl;
+    uint64_t ops;
+    uint64_t keyspace;
+    uint64_t seed;
+    uint64_t hits;
+    uint64_t corrupt;
+} bench_thread_t;
+
+static uint64_t splitmix_64(uint64_t x) {
+    x += 0x9E3779B97f4A7C15;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+    return x ^ (x >> 31);
+}
+
+/// Derive the node stored for a hash from the hash itself so that readers can validate every entry they accept
+static max_nodescore_t node_for_hash(max_zobrist_t hash) {
+    return (max_nodescore_t){
+        .bestmove = max_smove_new(
+            max_6bit_to_0x88(max_6bit_raw(hash & 0x3F)),
+            max_6bit_to_0x88(max_6bit_raw((hash >> 6) & 0x3F)),
+            (hash >> 20) & 0x0F
+        ),
+        .score = (max_score_t)((hash >> 12) & 0x3FFF) - 0x2000,
+        .kind = (hash >> 26) % 3,
+        .depth = (hash >> 28) & 0x0F,
+    };
+}
+
+static int bench_thread_main(void *data) {
+    bench_thread_t *bench = (bench_thread_t*)data;
+    uint64_t rng = bench->seed;
+
+    for(uint64_t i = 0; i < bench->ops; ++i) {
+        rng = splitmix_64(rng);
+        max_zobrist_t hash = (max_zobrist_t)splitmix_64(rng % bench->keyspace) | 1;
+        max_nodescore_t node = node_for_hash(hash);
+
+        if((rng >> 60) < 4) {
+            max_ttbl_probe_insert(bench->tbl, hash, node);
+        } else {
+            max_ttentry_data_t read;
+            if(max_ttbl_probe_read(bench->tbl, hash, &read)) {
+                bench->hits += 1;
+                if(
+                    max_ttentry_data_score(read) != node.score ||
+                    max_ttentry_data_depth(read) != node.depth ||
+                    max_ttentry_data_kind(read) != node.kind ||
+                    !max_smove_eq(max_ttentry_data_move(read), node.bestmove)
+                ) {
+                    bench->corrupt += 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    max_init();
+
+    uint8_t nbit = (argc > 1) ? (uint8_t)strtoul(argv[1], NULL, 10) : 20;
+    unsigned max_threads = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 10) : 8;
+    uint64_t ops = (argc > 3) ? strtoull(argv[3], NULL, 10) : 4000000;
+
+    if(max_threads == 0 || max_threads > MAX_BENCH_THREADS || nbit == 0 || nbit >= 32) {
+        printf("usage: %s [table bucket bits] [max threads] [operations per thread]\n", argv[0]);
+        return -1;
+    }
+
+    size_t size = sizeof(max_ttbucket_t) << nbit;
+#ifdef _WIN32
+    max_ttbucket_t *buf = _aligned_malloc(size, MAX_TTBUCKET_SIZE);
+#else
+    max_ttbucket_t *buf = aligned_alloc(MAX_TTBUCKET_SIZE, size);
+#endif
+    if(buf == NULL) {
+        printf("Failed to allocate transposition table with %u bits\n", nbit);
+        return -1;
+    }
+
+    static bench_thread_t bench[MAX_BENCH_THREADS];
+    static thrd_t threads[MAX_BENCH_THREADS];
+
+    printf("%-8s %-14s %-14s %-10s %s\n", "threads", "total Mops/s", "Mops/s/thread", "hit rate", "corrupt reads");
+    for(unsigned count = 1; count <= max_threads; count <<= 1) {
+        max_ttbl_t tbl;
+        max_ttbl_new(&tbl, buf, nbit);
+
+        for(unsigned i = 0; i < count; ++i) {
+            bench[i] = (bench_thread_t){
+                .tbl = &tbl,
+                .ops = ops,
+                .keyspace = (uint64_t)(4 * MAX_TTBUCKET_LEN) << nbit,
+                .seed = splitmix_64(i + 1),
+                .hits = 0,
+                .corrupt = 0,
+            };
+        }
+
+        double start = now_seconds();
+        for(unsigned i = 0; i < count; ++i) {
+            thrd_create(&threads[i], bench_thread_main, &bench[i]);
+        }
+
+        uint64_t hits = 0;
+        uint64_t corrupt = 0;
+        for(unsigned i = 0; i < count; ++i) {
+            thrd_join(threads[i], NULL);
+            hits += bench[i].hits;
+            corrupt += bench[i].corrupt;
+        }
+        double elapsed = now_seconds() - start;
+
+        double mops = (double)(ops * count) / elapsed / 1e6;
+        printf(
+            "%-8u %-14.2f %-14.2f %-10.3f %" PRIu64 "\n",
+            count,
+            mops,
+            mops / count,
+            (double)hits / (double)(ops * count),
+            corrupt
+        );
+    }
+
+#ifdef _WIN32
+    _aligned_free(buf);
+#else
+    free(buf);
+#endif
+    return 0;
+}
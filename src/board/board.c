@@ -10,6 +10,11 @@
 #include "private/board/piecelist.h"
 #include "private/board/state.h"
 #include "private/board/zobrist.h"
+#include <string.h>
+
+/// Table used by boards that have no piece-square scores set, so that the piece bookkeeping never has to check for
+/// a missing table
+static const max_psqt_t MAX_BOARD_PSQT_NONE;
 
 static void max_chessboard_init_pieces(max_board_t *board) {
     for(unsigned i = 0; i < MAX_0x88_LEN; ++i) {
@@ -26,9 +31,32 @@ void max_board_new(max_board_t *board, max_state_t *buffer, uint64_t seed) {
     MAX_ASSERT(MAX_INITIALIZED && "Board static lookup tables have not yet been initialized with max_init()");
     max_zobrist_elements_init(&board->zobrist_state, seed);
     board->stack.plates = buffer;
+    board->psqt = &MAX_BOARD_PSQT_NONE;
     max_board_reset(board);
 }
 
+void max_board_clone(max_board_t *dst, max_board_t const *src, max_state_t *buffer) {
+    *dst = *src;
+    memcpy(buffer, src->stack.plates, (src->stack.head + 1) * sizeof(*buffer));
+    dst->stack.plates = buffer;
+    dst->stack.head_ptr = buffer + src->stack.head;
+}
+
+void max_board_set_psqt(max_board_t *board, max_psqt_t const *psqt) {
+    board->psqt = (psqt == NULL) ? &MAX_BOARD_PSQT_NONE : psqt;
+    board->score = (max_phasescore_t){ .mg = 0, .eg = 0 };
+    board->phase = 0;
+
+    for(unsigned i = 0; i < MAX_6BIT_LEN; ++i) {
+        max_0x88_t pos = max_6bit_to_0x88(max_6bit_raw(i));
+        max_piececode_t piece = board->pieces[pos.v];
+        if(piece.v != MAX_PIECECODE_EMPTY) {
+            max_phasescore_add(&board->score, max_board_psqt_element(board, pos, piece));
+            board->phase += max_board_psqt_phase(board, piece);
+        }
+    }
+}
+
 void max_board_reset(max_board_t *board) {
     max_chessboard_init_pieces(board);
 
@@ -39,6 +67,8 @@ void max_board_reset(max_board_t *board) {
     max_state_stack_new(&board->stack, board->stack.plates, max_state_default());
 
     board->ply = 0;
+    board->score = (max_phasescore_t){ .mg = 0, .eg = 0 };
+    board->phase = 0;
 }
 
 bool max_board_empty_between_with_dir(max_board_t *board, max_0x88_t from, max_0x88_t to, max_0x88_dir_t dir) {
@@ -67,9 +97,17 @@ void max_board_add_piece_to_side(max_board_t *board, max_pieces_t *side, max_0x8
     max_lidx_t idx = max_loclist_add(list, pos);
     board->indices[pos.v] = idx;
     
-    //Update the zobrist key of the current position with XOR
+    //Update the zobrist keys of the current position with XOR
     max_state_t *state = max_board_state(board);
-    state->position ^= max_zobrist_position_element(&board->zobrist_state, pos, piece);
+    max_zobrist_t element = max_zobrist_position_element(&board->zobrist_state, pos, piece);
+    state->position ^= element;
+    if((piece.v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_PAWN) {
+        state->pawns ^= element;
+    }
+
+    state->material ^= max_zobrist_material_element(&board->zobrist_state, piece, idx);
+    max_phasescore_add(&board->score, max_board_psqt_element(board, pos, piece));
+    board->phase += max_board_psqt_phase(board, piece);
 }
 
 void max_board_move_piece_from_side(max_board_t *board, max_pieces_t *side, max_0x88_t from, max_0x88_t to) {
@@ -83,14 +121,22 @@ void max_board_move_piece_from_side(max_board_t *board, max_pieces_t *side, max_
     list->loc[idx] = to;
     board->indices[to.v] = idx;
     
-    //Modify the piececode table and the zobrist key of the current position to reflect the moved piece
+    //Modify the piececode table and the zobrist keys of the current position to reflect the moved piece
     max_state_t *state = max_board_state(board);
     
     board->pieces[from.v].v = MAX_PIECECODE_EMPTY;
-    state->position ^= max_zobrist_position_element(&board->zobrist_state, from, piece);
-    
     board->pieces[to.v] = piece;
-    state->position ^= max_zobrist_position_element(&board->zobrist_state, to, piece);
+
+    max_zobrist_t element =
+        max_zobrist_position_element(&board->zobrist_state, from, piece) ^
+        max_zobrist_position_element(&board->zobrist_state, to, piece);
+    state->position ^= element;
+    if((piece.v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_PAWN) {
+        state->pawns ^= element;
+    }
+
+    max_phasescore_sub(&board->score, max_board_psqt_element(board, from, piece));
+    max_phasescore_add(&board->score, max_board_psqt_element(board, to, piece));
 }
 
 max_piececode_t max_board_remove_piece_from_side(max_board_t *board, max_pieces_t *side, max_0x88_t pos) {
@@ -106,9 +152,17 @@ max_piececode_t max_board_remove_piece_from_side(max_board_t *board, max_pieces_
     max_0x88_t updated = max_loclist_remove(list, idx);
     board->indices[updated.v] = idx;
     
-    //Update the zobrist hash to reflect the removed piece from the square
+    //Update the zobrist hashes to reflect the removed piece from the square
     max_state_t *state = max_board_state(board);
-    state->position ^= max_zobrist_position_element(&board->zobrist_state, pos, piece);
+    max_zobrist_t element = max_zobrist_position_element(&board->zobrist_state, pos, piece);
+    state->position ^= element;
+    if((piece.v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_PAWN) {
+        state->pawns ^= element;
+    }
+
+    state->material ^= max_zobrist_material_element(&board->zobrist_state, piece, list->len);
+    max_phasescore_sub(&board->score, max_board_psqt_element(board, pos, piece));
+    board->phase -= max_board_psqt_phase(board, piece);
     return piece;
 }
 
@@ -141,6 +195,7 @@ void max_board_default_pos(max_board_t *board) {
 
 void max_board_tests(void) {
     max_board_check_unit_tests();
+    max_board_attackers_unit_tests();
     max_board_legality_unit_tests();
     max_board_perft_unit_tests();
 }
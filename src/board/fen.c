@@ -5,7 +5,9 @@
 #include "max/board/squares.h"
 #include "max/board/state.h"
 #include "private/board/board.h"
+#include "private/board/movegen.h"
 #include "private/board/state.h"
+#include "private/board/zobrist.h"
 #include <ctype.h>
 #include <stdint.h>
 
@@ -160,7 +162,8 @@ static inline char const *max_board_skip_whitespace(max_board_t *board, char con
     return fen;
 }
 
-max_fen_parse_err_t max_board_parse_from_fen(max_board_t *board, const char *fen) {
+/// Parse all fields of a FEN string into the given board, without updating any state derived from the position.
+static max_fen_parse_err_t max_board_parse_fen_fields(max_board_t *board, const char *fen) {
     max_board_reset(board);
     
     max_fen_parse_result_t res;
@@ -187,6 +190,9 @@ max_fen_parse_err_t max_board_parse_from_fen(max_board_t *board, const char *fen
     fen += 1;
 
     board->ply = side;
+    if(side == MAX_SIDE_BLACK) {
+        max_board_state(board)->position ^= max_zobrist_side_element(&board->zobrist_state);
+    }
 
     fen = max_board_skip_whitespace(board, fen);
     if(*fen == '-') {
@@ -224,6 +230,15 @@ max_fen_parse_err_t max_board_parse_from_fen(max_board_t *board, const char *fen
     return MAX_FEN_SUCCESS;
 }
 
+max_fen_parse_err_t max_board_parse_from_fen(max_board_t *board, const char *fen) {
+    max_fen_parse_err_t err = max_board_parse_fen_fields(board, fen);
+    if(err == MAX_FEN_SUCCESS) {
+        max_board_detect_check(board);
+    }
+
+    return err;
+}
+
 
 const char *max_fen_parse_err_str(max_fen_parse_err_t ec) {
     static const char *const STR[] = {
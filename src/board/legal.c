@@ -8,6 +8,9 @@
 #include "max/def.h"
 #include "private/board/board.h"
 #include "max/board/movegen/king.h"
+#include "max/board/movegen/pawn.h"
+#include "private/board/movegen/king.h"
+#include "private/board/movegen/knight.h"
 
 
 /// Check if a piece on the given square is pinned by an enemy slider to the friendly king.
@@ -49,7 +52,6 @@ static MAX_INLINE_ALWAYS max_0x88_dir_t max_board_piece_is_pinned(max_board_t *b
 }
 
 bool max_board_legal(max_board_t *board, max_smove_t move) {
-    static max_smove_t buf[512];
     max_state_t *state = max_board_state(board);
 
     max_piececode_t moved = board->pieces[move.from.v];
@@ -164,3 +166,196 @@ bool max_board_legal(max_board_t *board, max_smove_t move) {
 
     return true;
 }
+
+void max_board_legalmask(max_board_t *board, max_legalmask_t *mask) {
+    max_state_t *state = max_board_state(board);
+    max_side_t side = max_board_side(board);
+    max_0x88_t kpos = *max_board_side_list(board, side)->king.loc;
+    max_piecemask_t friendly = max_side_color_mask(side);
+    max_piecemask_t enemy = max_side_enemy_color_mask(side);
+
+    mask->king = kpos;
+    mask->pinned = 0;
+
+    //A friendly piece is pinned if it is the only piece between the king and an enemy slider moving along the same ray
+    for(unsigned i = 0; i < MAX_0x88_RAYS_LEN; ++i) {
+        max_0x88_dir_t dir = MAX_0x88_RAYS[i];
+        max_piecemask_t sliders = max_0x88_piecemask_for_dir(dir);
+        max_0x88_t blocker = kpos;
+        max_0x88_t scan = kpos;
+
+        for(;;) {
+            scan = max_0x88_move(scan, dir);
+            if(!max_0x88_valid(scan)) {
+                break;
+            }
+
+            max_piececode_t piece = board->pieces[scan.v];
+            if(piece.v == MAX_PIECECODE_EMPTY) {
+                continue;
+            }
+
+            if(blocker.v == kpos.v) {
+                if(!max_piececode_match(piece, friendly)) {
+                    break;
+                }
+
+                blocker = scan;
+            } else {
+                if(max_piececode_match(piece, enemy) && max_piececode_match(piece, sliders)) {
+                    mask->pinned |= max_legalmask_bit(blocker);
+                }
+
+                break;
+            }
+        }
+    }
+
+    if(max_check_is_empty(state->check[0])) {
+        mask->evasions = UINT64_MAX;
+    } else if(max_check_has_value(state->check[1])) {
+        mask->evasions = 0;
+    } else {
+        max_check_t check = state->check[0];
+        mask->evasions = max_legalmask_bit(check.origin);
+        if(max_check_is_sliding(check)) {
+            for(max_0x88_t scan = max_0x88_move(kpos, check.ray); scan.v != check.origin.v; scan = max_0x88_move(scan, check.ray)) {
+                mask->evasions |= max_legalmask_bit(scan);
+            }
+        }
+    }
+}
+
+/// Check if a pawn of the side to play can make the given move, assuming that the destination square is already
+/// known to be empty for quiet moves or occupied by an enemy piece for captures.
+static bool max_board_pawn_pseudolegal(max_board_t *board, max_smove_t move, max_side_t side) {
+    max_0x88_dir_t advance = MAX_PAWN_ADVANCE_DIR[side];
+    max_0x88_t advanced = max_0x88_move(move.from, advance);
+
+    switch(move.tag & ~MAX_MOVETAG_CAPTURE) {
+        case MAX_MOVETAG_DOUBLE: {
+            return
+                move.tag == MAX_MOVETAG_DOUBLE &&
+                max_0x88_rank(move.from) == MAX_PAWN_HOMERANK[side] &&
+                board->pieces[advanced.v].v == MAX_PIECECODE_EMPTY &&
+                max_0x88_move(advanced, advance).v == move.to.v;
+        } break;
+
+        case MAX_MOVETAG_ENPASSANT: {
+            max_packed_state_t packed = max_board_state(board)->packed;
+            if(move.tag != MAX_MOVETAG_ENPASSANT || !max_packed_state_has_ep(packed)) {
+                return false;
+            }
+
+            max_0x88_t epsquare = max_0x88_move(
+                max_0x88_new(MAX_PAWN_EP_RANK[side], max_packed_state_epfile(packed)),
+                advance
+            );
+
+            return
+                epsquare.v == move.to.v &&
+                (
+                    max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[0]).v == move.to.v ||
+                    max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[1]).v == move.to.v
+                );
+        } break;
+
+        default: {
+            //Pawns reaching the last rank must promote, and can only promote on the last rank
+            if(max_movetag_is_promote(move.tag) != (max_0x88_rank(move.to) == MAX_PAWN_PROMOTE_RANK[side])) {
+                return false;
+            }
+
+            if(move.tag & MAX_MOVETAG_CAPTURE) {
+                return
+                    max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[0]).v == move.to.v ||
+                    max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[1]).v == move.to.v;
+            } else {
+                return advanced.v == move.to.v;
+            }
+        } break;
+    }
+}
+
+bool max_board_pseudolegal(max_board_t *board, max_smove_t move) {
+    if(!max_0x88_valid(move.from) || !max_0x88_valid(move.to) || move.from.v == move.to.v) {
+        return false;
+    }
+
+    max_side_t side = max_board_side(board);
+    max_piececode_t moved = board->pieces[move.from.v];
+    if(!max_piececode_match(moved, max_side_color_mask(side))) {
+        return false;
+    }
+
+    uint8_t kind = moved.v & MAX_PIECECODE_TYPE_MASK;
+
+    if(max_movetag_is_castle(move.tag)) {
+        max_state_t *state = max_board_state(board);
+        max_castle_side_t castle = max_castle_side_for_movetag(move.tag);
+        if(
+            kind != MAX_PIECECODE_KING ||
+            !max_check_is_empty(state->check[0]) ||
+            (state->packed & max_packed_state_castle(side, castle)) == 0
+        ) {
+            return false;
+        }
+
+        //Reuse castle movegen to validate the squares between king and rook
+        max_smove_t castle_move;
+        max_movelist_t castle_list;
+        max_movelist_new(&castle_list, &castle_move, 1);
+        max_board_movegen_castle(board, &castle_list, max_board_side_list(board, side), castle);
+        return castle_list.len == 1 && max_smove_eq(castle_move, move);
+    }
+
+    max_piececode_t target = board->pieces[move.to.v];
+    if(move.tag & MAX_MOVETAG_CAPTURE) {
+        if(
+            !max_piececode_match(target, max_side_enemy_color_mask(side)) ||
+            (target.v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_KING
+        ) {
+            return false;
+        }
+    } else if(target.v != MAX_PIECECODE_EMPTY) {
+        return false;
+    }
+
+    if(kind == MAX_PIECECODE_PAWN) {
+        return max_board_pawn_pseudolegal(board, move, side);
+    }
+
+    //Only pawns may make moves other than quiet moves and captures
+    if((move.tag & ~MAX_MOVETAG_CAPTURE) != MAX_MOVETAG_NONE) {
+        return false;
+    }
+
+    switch(kind) {
+        case MAX_PIECECODE_KNIGHT: {
+            for(unsigned i = 0; i < MAX_KNIGHT_MOVES_LEN; ++i) {
+                if(max_0x88_move(move.from, MAX_KNIGHT_MOVES[i]).v == move.to.v) {
+                    return true;
+                }
+            }
+
+            return false;
+        } break;
+
+        case MAX_PIECECODE_KING: {
+            for(unsigned i = 0; i < MAX_KING_MOVES_LEN; ++i) {
+                if(max_0x88_move(move.from, MAX_KING_MOVES[i]).v == move.to.v) {
+                    return true;
+                }
+            }
+
+            return false;
+        } break;
+
+        default: {
+            max_0x88_dir_t dir = max_0x88_line(move.from, move.to);
+            return
+                max_piececode_match(moved, max_0x88_piecemask_for_dir(dir)) &&
+                max_board_empty_between_with_dir(board, move.from, move.to, dir);
+        } break;
+    }
+}
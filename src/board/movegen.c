@@ -2,6 +2,7 @@
 #include "max/board/dir.h"
 #include "max/board/movegen/king.h"
 #include "max/board/piececode.h"
+#include "max/board/piecelist.h"
 #include "max/board/state.h"
 #include "private/board/board.h"
 #include "max/board/move.h"
@@ -79,3 +80,181 @@ void max_board_movegen(max_board_t *board, max_movelist_t *list) {
         }
     }
 }
+
+void max_board_movegen_captures(max_board_t *board, max_movelist_t *list) {
+    max_side_t side = max_board_side(board);
+    max_pieces_t *pieces = max_board_side_list(board, side);
+    max_piecemask_t enemy = max_side_enemy_color_mask(side);
+
+    max_board_movegen_pawn_captures(board, list, pieces, enemy, side);
+
+    for(unsigned i = 0; i < pieces->knight.len; ++i) {
+        max_0x88_t from = pieces->knight.loc[i];
+        for(unsigned j = 0; j < MAX_KNIGHT_MOVES_LEN; ++j) {
+            max_board_movegen_capture(board, list, enemy, from, max_0x88_move(from, MAX_KNIGHT_MOVES[j]));
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->bishop.len; ++i) {
+        max_0x88_t from = pieces->bishop.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_DIAGONALS_LEN; ++j) {
+            max_board_movegen_slide_captures(board, list, enemy, from, MAX_0x88_DIAGONALS[j]);
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->rook.len; ++i) {
+        max_0x88_t from = pieces->rook.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_CARDINALS_LEN; ++j) {
+            max_board_movegen_slide_captures(board, list, enemy, from, MAX_0x88_CARDINALS[j]);
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->queen.len; ++i) {
+        max_0x88_t from = pieces->queen.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_RAYS_LEN; ++j) {
+            max_board_movegen_slide_captures(board, list, enemy, from, MAX_0x88_RAYS[j]);
+        }
+    }
+
+    max_0x88_t from = pieces->king.loc[0];
+    for(unsigned i = 0; i < MAX_KING_MOVES_LEN; ++i) {
+        max_board_movegen_capture(board, list, enemy, from, max_0x88_move(from, MAX_KING_MOVES[i]));
+    }
+}
+
+void max_board_movegen_quiets(max_board_t *board, max_movelist_t *list) {
+    max_state_t *state = max_board_state(board);
+    max_side_t side = max_board_side(board);
+    max_pieces_t *pieces = max_board_side_list(board, side);
+
+    max_board_movegen_pawn_quiets(board, list, pieces, side);
+
+    for(unsigned i = 0; i < pieces->knight.len; ++i) {
+        max_0x88_t from = pieces->knight.loc[i];
+        for(unsigned j = 0; j < MAX_KNIGHT_MOVES_LEN; ++j) {
+            max_board_movegen_quiet(board, list, from, max_0x88_move(from, MAX_KNIGHT_MOVES[j]));
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->bishop.len; ++i) {
+        max_0x88_t from = pieces->bishop.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_DIAGONALS_LEN; ++j) {
+            max_board_movegen_slide_quiets(board, list, from, MAX_0x88_DIAGONALS[j]);
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->rook.len; ++i) {
+        max_0x88_t from = pieces->rook.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_CARDINALS_LEN; ++j) {
+            max_board_movegen_slide_quiets(board, list, from, MAX_0x88_CARDINALS[j]);
+        }
+    }
+
+    for(unsigned i = 0; i < pieces->queen.len; ++i) {
+        max_0x88_t from = pieces->queen.loc[i];
+        for(unsigned j = 0; j < MAX_0x88_RAYS_LEN; ++j) {
+            max_board_movegen_slide_quiets(board, list, from, MAX_0x88_RAYS[j]);
+        }
+    }
+
+    max_0x88_t from = pieces->king.loc[0];
+    for(unsigned i = 0; i < MAX_KING_MOVES_LEN; ++i) {
+        max_board_movegen_quiet(board, list, from, max_0x88_move(from, MAX_KING_MOVES[i]));
+    }
+
+    if(max_check_is_empty(state->check[0])) {
+        if(max_packed_state_hcastle(side) & state->packed) {
+            max_board_movegen_castle(board, list, pieces, MAX_CASTLE_HSIDE);
+        }
+        if(max_packed_state_acastle(side) & state->packed) {
+            max_board_movegen_castle(board, list, pieces, MAX_CASTLE_ASIDE);
+        }
+    }
+}
+
+void max_board_movegen_evasions(max_board_t *board, max_movelist_t *list, max_legalmask_t const *mask) {
+    max_side_t side = max_board_side(board);
+    max_pieces_t *pieces = max_board_side_list(board, side);
+    max_piecemask_t enemy = max_side_enemy_color_mask(side);
+
+    for(unsigned i = 0; i < MAX_KING_MOVES_LEN; ++i) {
+        max_board_movegen_attack(board, list, enemy, mask->king, max_0x88_move(mask->king, MAX_KING_MOVES[i]));
+    }
+
+    //Only the king may move out of double check
+    if(mask->evasions == 0) {
+        return;
+    }
+
+    max_board_movegen_pawns(board, list, pieces, enemy, side);
+
+    for(unsigned i = 0; i < pieces->knight.len; ++i) {
+        max_0x88_t from = pieces->knight.loc[i];
+        for(unsigned j = 0; j < MAX_KNIGHT_MOVES_LEN; ++j) {
+            max_0x88_t to = max_0x88_move(from, MAX_KNIGHT_MOVES[j]);
+            if(max_0x88_valid(to) && (mask->evasions & max_legalmask_bit(to))) {
+                max_board_movegen_attack(board, list, enemy, from, to);
+            }
+        }
+    }
+
+    //Sliders can only block or capture along the line between the checker and the king, so test each target directly
+    max_0x88_t targets[8];
+    unsigned targets_len = 0;
+    max_check_t check = max_board_state(board)->check[0];
+    if(max_check_is_sliding(check)) {
+        for(max_0x88_t scan = max_0x88_move(mask->king, check.ray); scan.v != check.origin.v; scan = max_0x88_move(scan, check.ray)) {
+            targets[targets_len++] = scan;
+        }
+    }
+
+    targets[targets_len++] = check.origin;
+
+    max_loclist_t *slider_lists[] = {
+        (max_loclist_t*)(&pieces->bishop),
+        (max_loclist_t*)(&pieces->rook),
+        (max_loclist_t*)(&pieces->queen),
+    };
+    for(unsigned l = 0; l < sizeof(slider_lists) / sizeof(slider_lists[0]); ++l) {
+        for(unsigned i = 0; i < slider_lists[l]->len; ++i) {
+            max_0x88_t from = slider_lists[l]->loc[i];
+            max_piececode_t piece = board->pieces[from.v];
+            for(unsigned j = 0; j < targets_len; ++j) {
+                max_0x88_dir_t dir = max_0x88_line(from, targets[j]);
+                if(
+                    max_piececode_match(piece, max_0x88_piecemask_for_dir(dir)) &&
+                    max_board_empty_between_with_dir(board, from, targets[j], dir)
+                ) {
+                    max_board_movegen_attack(board, list, enemy, from, targets[j]);
+                }
+            }
+        }
+    }
+}
+
+void max_board_movegen_retain_legal(max_board_t *board, max_legalmask_t const *mask, max_movelist_t *list, uint16_t start) {
+    uint16_t kept = start;
+    for(uint16_t i = start; i < list->len; ++i) {
+        max_smove_t move = list->buf[i];
+        if(max_board_legal_masked(board, mask, move)) {
+            list->buf[kept] = move;
+            kept += 1;
+        }
+    }
+
+    list->len = kept;
+}
+
+void max_board_movegen_legal(max_board_t *board, max_movelist_t *list) {
+    max_legalmask_t mask;
+    max_board_legalmask(board, &mask);
+
+    uint16_t start = list->len;
+    if(max_check_has_value(max_board_state(board)->check[0])) {
+        max_board_movegen_evasions(board, list, &mask);
+    } else {
+        max_board_movegen(board, list);
+    }
+
+    max_board_movegen_retain_legal(board, &mask, list, start);
+}
@@ -56,16 +56,27 @@ static void max_board_movegen_pawn_attack(max_board_t *board, max_movelist_t *li
     }
 }
 
+/// Add an en passant capture for the pawn on the given square if one is available
+static void max_board_movegen_pawn_ep(max_board_t *board, max_movelist_t *list, max_0x88_t from, max_side_t side) {
+    max_state_t *state = max_board_state(board);
+    uint8_t const en_passant_rank = MAX_PAWN_EP_RANK[side];
+
+    if(max_packed_state_has_ep(state->packed) && max_0x88_rank(from) == en_passant_rank) {
+        uint8_t filediff = (7 + max_0x88_file(from)) - max_packed_state_epfile(state->packed);
+        if(filediff == 6 || filediff == 8) {
+
+            max_0x88_t epsquare = max_0x88_new(en_passant_rank, max_packed_state_epfile(state->packed));
+            epsquare = max_0x88_move(epsquare, MAX_PAWN_ADVANCE_DIR[side]);
+            max_movelist_add(list, max_smove_new(from, epsquare, MAX_MOVETAG_ENPASSANT));
+        }
+    }
+}
+
 void max_board_movegen_pawns(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_piecemask_t enemy, max_side_t side) {
     max_0x88_dir_t const advance = MAX_PAWN_ADVANCE_DIR[side];
     uint8_t const promote_rank = MAX_PAWN_PROMOTE_RANK[side];
-    uint8_t const en_passant_rank = MAX_PAWN_EP_RANK[side];
     uint8_t const homerank = MAX_PAWN_HOMERANK[side];
 
-    max_state_t *state = max_board_state(board);
-    bool has_ep = max_packed_state_has_ep(state->packed);
-    
-
     for(unsigned i = 0; i < pieces->pawn.len; ++i) {
         max_0x88_t from = pieces->pawn.loc[i];
         max_0x88_t advanced_from = max_0x88_move(from, advance);
@@ -89,13 +100,48 @@ void max_board_movegen_pawns(max_board_t *board, max_movelist_t *list, max_piece
             max_board_movegen_pawn_attack(board, list, enemy, from, max_0x88_move(advanced_from, MAX_PAWN_ATTACK_SIDES[1]));
         }
         
-        if(has_ep && max_0x88_rank(from) == en_passant_rank) {
-            uint8_t filediff = (7 + max_0x88_file(from)) - max_packed_state_epfile(state->packed);
-            if(filediff == 6 || filediff == 8) {
+        max_board_movegen_pawn_ep(board, list, from, side);
+    }
+}
+
+void max_board_movegen_pawn_captures(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_piecemask_t enemy, max_side_t side) {
+    max_0x88_dir_t const advance = MAX_PAWN_ADVANCE_DIR[side];
+    uint8_t const promote_rank = MAX_PAWN_PROMOTE_RANK[side];
+
+    for(unsigned i = 0; i < pieces->pawn.len; ++i) {
+        max_0x88_t from = pieces->pawn.loc[i];
+        max_0x88_t advanced_from = max_0x88_move(from, advance);
+        
+        //Pushes to the promotion rank change material and are generated alongside captures
+        if(max_0x88_rank(advanced_from) == promote_rank) {
+            if(board->pieces[advanced_from.v].v == MAX_PIECECODE_EMPTY) {
+                max_board_movegen_pawn_promotions(list, from, advanced_from, MAX_MOVETAG_NONE);
+            }
+            max_board_movegen_pawn_attack_promote(board, list, enemy, from, max_0x88_move(advanced_from, MAX_PAWN_ATTACK_SIDES[0])); 
+            max_board_movegen_pawn_attack_promote(board, list, enemy, from, max_0x88_move(advanced_from, MAX_PAWN_ATTACK_SIDES[1]));
+        } else {
+            max_board_movegen_pawn_attack(board, list, enemy, from, max_0x88_move(advanced_from, MAX_PAWN_ATTACK_SIDES[0])); 
+            max_board_movegen_pawn_attack(board, list, enemy, from, max_0x88_move(advanced_from, MAX_PAWN_ATTACK_SIDES[1]));
+        }
+        
+        max_board_movegen_pawn_ep(board, list, from, side);
+    }
+}
+
+void max_board_movegen_pawn_quiets(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_side_t side) {
+    max_0x88_dir_t const advance = MAX_PAWN_ADVANCE_DIR[side];
+    uint8_t const promote_rank = MAX_PAWN_PROMOTE_RANK[side];
+    uint8_t const homerank = MAX_PAWN_HOMERANK[side];
+
+    for(unsigned i = 0; i < pieces->pawn.len; ++i) {
+        max_0x88_t from = pieces->pawn.loc[i];
+        max_0x88_t advanced_from = max_0x88_move(from, advance);
 
-                max_0x88_t epsquare = max_0x88_new(en_passant_rank, max_packed_state_epfile(state->packed));
-                epsquare = max_0x88_move(epsquare, advance);
-                max_movelist_add(list, max_smove_new(from, epsquare, MAX_MOVETAG_ENPASSANT));
+        if(max_0x88_rank(advanced_from) != promote_rank && board->pieces[advanced_from.v].v == MAX_PIECECODE_EMPTY) {
+            max_movelist_add(list, max_smove_normal(from, advanced_from));
+            max_0x88_t double_move = max_0x88_move(advanced_from, advance);
+            if(max_0x88_rank(from) == homerank && board->pieces[double_move.v].v == MAX_PIECECODE_EMPTY) {
+                max_movelist_add(list, max_smove_new(from, double_move, MAX_MOVETAG_DOUBLE));
             }
         }
     }
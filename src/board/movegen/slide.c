@@ -11,3 +11,24 @@ void max_board_movegen_slide(max_board_t *board, max_movelist_t *list, max_piece
         }
     }
 }
+
+void max_board_movegen_slide_captures(max_board_t *board, max_movelist_t *list, max_piecemask_t enemy, max_0x88_t source, max_0x88_dir_t ray) {
+    max_0x88_t dest = source;
+    do {
+        dest = max_0x88_move(dest, ray);
+    } while(max_0x88_valid(dest) && board->pieces[dest.v].v == MAX_PIECECODE_EMPTY);
+
+    max_board_movegen_capture(board, list, enemy, source, dest);
+}
+
+void max_board_movegen_slide_quiets(max_board_t *board, max_movelist_t *list, max_0x88_t source, max_0x88_dir_t ray) {
+    max_0x88_t dest = source;
+    for(;;) {
+        dest = max_0x88_move(dest, ray);
+        if(!max_0x88_valid(dest) || board->pieces[dest.v].v != MAX_PIECECODE_EMPTY) {
+            return;
+        }
+
+        max_movelist_add(list, max_smove_normal(source, dest));
+    }
+}
@@ -31,4 +31,45 @@ void max_board_check_unit_tests(void) {
     );
 }
 
+void max_board_attackers_unit_tests(void) {
+    max_state_t buf[4];
+    max_board_t board;
+    max_board_new(&board, buf, MAX_ZOBRIST_DEFAULT_SEED);
+
+    ASSERT(
+        max_board_parse_from_fen(&board, "3rk3/3q4/8/3p4/4P3/2NR4/3Q4/4K3 w - - 0 1") == MAX_FEN_SUCCESS,
+        "FEN parse when setting up attacker unit test fails"
+    );
+
+    max_attackers_t attackers;
+    max_board_attackers(&board, MAX_D5, &attackers);
+
+    unsigned white = 0;
+    unsigned black = 0;
+    unsigned xray_ok = 0;
+    for(unsigned i = 0; i < attackers.len; ++i) {
+        max_attacker_t attacker = attackers.buf[i];
+        if(max_piececode_side(attacker.piece) == MAX_SIDE_WHITE) {
+            white += 1;
+        } else {
+            black += 1;
+        }
+
+        if(attacker.behind != MAX_ATTACKER_DIRECT) {
+            max_0x88_t front = attackers.buf[attacker.behind].loc;
+            xray_ok +=
+                (attacker.loc.v == MAX_D2.v && front.v == MAX_D3.v) ||
+                (attacker.loc.v == MAX_D8.v && front.v == MAX_D7.v);
+        }
+    }
+
+    ASSERT(
+        white == 4 && black == 2 && xray_ok == 2,
+        "Attackers of d5 found %u white and %u black attackers with %u correct x-rays",
+        white,
+        black,
+        xray_ok
+    );
+}
+
 #endif
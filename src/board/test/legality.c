@@ -8,6 +8,129 @@
 
 #ifdef MAX_TESTS
 
+/// Positions containing castling, en passant, promotions, and checks used to compare pseudo-legality checks with movegen
+static char const *MAX_PSEUDOLEGAL_TEST_FENS[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/Pp2P3/2N2Q1p/1PPBBPPP/R3K2R b KQkq a3 0 1",
+    "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3",
+    "rnbqk1nr/pppp1ppp/8/4p3/1b1P4/8/PPP1PPPP/RNBQKBNR w KQkq - 1 3",
+};
+
+/// Every tag that a generated move may have
+static max_movetag_t const MAX_PSEUDOLEGAL_TEST_TAGS[] = {
+    MAX_MOVETAG_NONE,
+    MAX_MOVETAG_ENPASSANT,
+    MAX_MOVETAG_PKNIGHT,
+    MAX_MOVETAG_PBISHOP,
+    MAX_MOVETAG_PROOK,
+    MAX_MOVETAG_PQUEEN,
+    MAX_MOVETAG_DOUBLE,
+    MAX_MOVETAG_CAPTURE,
+    MAX_MOVETAG_CAPTURE | MAX_MOVETAG_PKNIGHT,
+    MAX_MOVETAG_CAPTURE | MAX_MOVETAG_PBISHOP,
+    MAX_MOVETAG_CAPTURE | MAX_MOVETAG_PROOK,
+    MAX_MOVETAG_CAPTURE | MAX_MOVETAG_PQUEEN,
+    MAX_MOVETAG_ACASTLE,
+    MAX_MOVETAG_HCASTLE,
+};
+
+/// Ensure that every possible move is accepted by max_board_pseudolegal() if and only if it is generated by movegen
+static void max_board_pseudolegal_unit_tests(max_board_t *board) {
+    max_smove_t buf[256];
+
+    for(unsigned i = 0; i < sizeof(MAX_PSEUDOLEGAL_TEST_FENS) / sizeof(MAX_PSEUDOLEGAL_TEST_FENS[0]); ++i) {
+        ASSERT(
+            max_board_parse_from_fen(board, MAX_PSEUDOLEGAL_TEST_FENS[i]) == MAX_FEN_SUCCESS,
+            "FEN parse when setting up pseudo-legality unit test fails"
+        );
+
+        max_movelist_t moves;
+        max_movelist_new(&moves, buf, 256);
+        max_board_movegen(board, &moves);
+
+        unsigned mismatched = 0;
+        for(unsigned from = 0; from < MAX_6BIT_LEN; ++from) {
+            for(unsigned to = 0; to < MAX_6BIT_LEN; ++to) {
+                for(unsigned t = 0; t < sizeof(MAX_PSEUDOLEGAL_TEST_TAGS) / sizeof(MAX_PSEUDOLEGAL_TEST_TAGS[0]); ++t) {
+                    max_smove_t move = max_smove_new(
+                        max_6bit_to_0x88(max_6bit_raw(from)),
+                        max_6bit_to_0x88(max_6bit_raw(to)),
+                        MAX_PSEUDOLEGAL_TEST_TAGS[t]
+                    );
+
+                    bool generated = false;
+                    for(unsigned j = 0; j < moves.len; ++j) {
+                        generated |= max_smove_eq(moves.buf[j], move);
+                    }
+
+                    mismatched += generated != max_board_pseudolegal(board, move);
+                }
+            }
+        }
+
+        ASSERT(
+            mismatched == 0,
+            "%u moves are incorrectly validated as pseudo-legal in position %s",
+            mismatched,
+            MAX_PSEUDOLEGAL_TEST_FENS[i]
+        );
+    }
+}
+
+/// Ensure that captures and quiet moves are generated separately without overlap and together match full movegen
+static void max_board_movegen_split_unit_tests(max_board_t *board) {
+    max_smove_t buf[256];
+    max_smove_t split[256];
+
+    for(unsigned i = 0; i < sizeof(MAX_PSEUDOLEGAL_TEST_FENS) / sizeof(MAX_PSEUDOLEGAL_TEST_FENS[0]); ++i) {
+        ASSERT(
+            max_board_parse_from_fen(board, MAX_PSEUDOLEGAL_TEST_FENS[i]) == MAX_FEN_SUCCESS,
+            "FEN parse when setting up split movegen unit test fails"
+        );
+
+        max_movelist_t moves;
+        max_movelist_new(&moves, buf, 256);
+        max_board_movegen(board, &moves);
+
+        max_movelist_t captures;
+        max_movelist_new(&captures, split, 256);
+        max_board_movegen_captures(board, &captures);
+        unsigned quiet_captures = 0;
+        for(unsigned j = 0; j < captures.len; ++j) {
+            max_movetag_t tag = captures.buf[j].tag;
+            quiet_captures += !(tag & MAX_MOVETAG_CAPTURE) && tag != MAX_MOVETAG_ENPASSANT && !max_movetag_is_promote(tag);
+        }
+
+        max_movelist_t quiets = max_movelist_slice(&captures);
+        max_board_movegen_quiets(board, &quiets);
+        unsigned tactical_quiets = 0;
+        for(unsigned j = 0; j < quiets.len; ++j) {
+            max_movetag_t tag = quiets.buf[j].tag;
+            tactical_quiets += (tag & MAX_MOVETAG_CAPTURE) || tag == MAX_MOVETAG_ENPASSANT || max_movetag_is_promote(tag);
+        }
+
+        unsigned mismatched = (captures.len + quiets.len) != moves.len;
+        for(unsigned j = 0; j < moves.len; ++j) {
+            unsigned count = 0;
+            for(unsigned k = 0; k < captures.len + quiets.len; ++k) {
+                count += max_smove_eq(moves.buf[j], split[k]);
+            }
+
+            mismatched += count != 1;
+        }
+
+        ASSERT(
+            quiet_captures == 0 && tactical_quiets == 0 && mismatched == 0,
+            "Split movegen in position %s yields %u quiet captures, %u tactical quiets, and %u mismatches",
+            MAX_PSEUDOLEGAL_TEST_FENS[i],
+            quiet_captures,
+            tactical_quiets,
+            mismatched
+        );
+    }
+}
+
 void max_board_legality_unit_tests(void) {
     max_state_t buf[10];
     max_board_t board;
@@ -35,6 +158,9 @@ void max_board_legality_unit_tests(void) {
         max_board_legal(&board, max_smove_normal(MAX_E1, MAX_F2)),
         "King move escaping sliding check is not marked legal"
     );
+
+    max_board_pseudolegal_unit_tests(&board);
+    max_board_movegen_split_unit_tests(&board);
 }
 
 #endif
@@ -1,4 +1,6 @@
 #include "max/board/perft.h"
+#include "max/board/fen.h"
+#include "max/board/squares.h"
 #include "max/board/move.h"
 #include "max/board/movegen.h"
 #include "private/board/board.h"
@@ -11,24 +13,17 @@ uint64_t max_board_perft(max_board_t *board,  max_movelist_t moves, uint8_t dept
         return 1;
     }
     
-    max_board_movegen(board, &moves);
+    max_board_movegen_legal(board, &moves);
+    if(depth == 1) {
+        return moves.len;
+    }
     
     uint64_t count = 0;
-    unsigned legal_moves = 0;
     for(unsigned i = 0; i < moves.len; ++i) {
         max_smove_t move = moves.buf[i];
-        if(max_board_legal(board, move)) {
-            legal_moves += 1;
-            
-            if(depth > 1) {
-                max_board_make_move(board, move);
-                count += max_board_perft(board, max_movelist_slice(&moves), depth - 1);
-                max_board_unmake_move(board, move);
-
-            } else {
-                count += 1;
-            }
-        }
+        max_board_make_move(board, move);
+        count += max_board_perft(board, max_movelist_slice(&moves), depth - 1);
+        max_board_unmake_move(board, move);
     }
 
     return count;
@@ -54,6 +49,18 @@ static const uint64_t EXPECTED_PERFT[] = {
 
 static const unsigned EXPECTED_PERFT_LEN = sizeof(EXPECTED_PERFT) / sizeof(EXPECTED_PERFT[0]);
 
+/// Positions exercising pins, check evasions, en passant, castling, and promotions with their expected perft counts
+static const struct {
+    char const *fen;
+    uint8_t depth;
+    uint64_t nodes;
+} EXPECTED_PERFT_POSITIONS[] = {
+    { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+    { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624 },
+    { "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ-- - 0 1", 3, 9467 },
+    { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ-- - 1 8", 3, 62379 },
+};
+
 void max_board_perft_unit_tests(void) {
     max_state_t state_buf[12];
     max_board_t board;
@@ -64,10 +71,87 @@ void max_board_perft_unit_tests(void) {
     max_movelist_t moves;
     max_movelist_new(&moves, buf, MAX_BOARD_TEST_MOVELIST_LEN);
     
+    max_zobrist_t root = max_board_state(&board)->position;
     for(unsigned i = 0; i < EXPECTED_PERFT_LEN; ++i) {
         uint64_t perft = max_board_perft(&board, moves, i + 1);
         ASSERT(perft == EXPECTED_PERFT[i], "perft(%u) invalid - got %zu nodes, expecting %zu nodes", i + 1, perft,  EXPECTED_PERFT[i]);
+        ASSERT(
+            max_board_state(&board)->position == root,
+            "Zobrist key of the root position modified after perft(%u)", i + 1
+        );
+    }
+
+    for(unsigned i = 0; i < sizeof(EXPECTED_PERFT_POSITIONS) / sizeof(EXPECTED_PERFT_POSITIONS[0]); ++i) {
+        ASSERT(
+            max_board_parse_from_fen(&board, EXPECTED_PERFT_POSITIONS[i].fen) == MAX_FEN_SUCCESS,
+            "FEN parse when setting up perft of %s fails",
+            EXPECTED_PERFT_POSITIONS[i].fen
+        );
+        uint64_t perft = max_board_perft(&board, moves, EXPECTED_PERFT_POSITIONS[i].depth);
+        ASSERT(
+            perft == EXPECTED_PERFT_POSITIONS[i].nodes,
+            "perft(%u) of %s invalid - got %zu nodes, expecting %zu nodes",
+            EXPECTED_PERFT_POSITIONS[i].depth,
+            EXPECTED_PERFT_POSITIONS[i].fen,
+            perft,
+            EXPECTED_PERFT_POSITIONS[i].nodes
+        );
     }
+
+    //The zobrist key after a capture must match the key of the same position set up from scratch
+    max_board_t captured;
+    max_state_t captured_buf[4];
+    max_board_new(&captured, captured_buf, MAX_ZOBRIST_DEFAULT_SEED);
+    max_board_parse_from_fen(&captured, "rnbqkbnr/ppp1pppp/8/3P4/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2");
+
+    max_board_parse_from_fen(&board, "rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2");
+    max_zobrist_t uncaptured = max_board_state(&board)->pawns;
+    max_board_make_move(&board, max_smove_capture(MAX_E4, MAX_D5));
+    ASSERT(
+        max_board_state(&board)->position == max_board_state(&captured)->position,
+        "Zobrist key after a capture does not match the key of the resulting position"
+    );
+    ASSERT(
+        max_board_state(&board)->pawns == max_board_state(&captured)->pawns,
+        "Pawn key after a pawn capture does not match the key of the resulting position"
+    );
+    ASSERT(
+        max_board_state(&board)->material == max_board_state(&captured)->material,
+        "Material key after a capture does not match the key of the resulting position"
+    );
+
+    //Moving a piece other than a pawn must leave the pawn key unchanged
+    max_zobrist_t pawns = max_board_state(&board)->pawns;
+    max_board_make_move(&board, max_smove_normal(MAX_G8, MAX_F6));
+    ASSERT(max_board_state(&board)->pawns == pawns, "Pawn key is changed by a knight move");
+    ASSERT(
+        max_board_state(&board)->material == max_board_state(&captured)->material,
+        "Material key is changed by a move that does not capture"
+    );
+    max_board_unmake_move(&board, max_smove_normal(MAX_G8, MAX_F6));
+    max_board_unmake_move(&board, max_smove_capture(MAX_E4, MAX_D5));
+    ASSERT(max_board_state(&board)->pawns == uncaptured, "Pawn key is not restored after unmaking a pawn capture");
+
+    //A null move must only change the side to play, and must be exactly reversed when unmade
+    max_board_parse_from_fen(&board, "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+    max_zobrist_t before = max_board_state(&board)->position;
+    uint64_t nodes = max_board_perft(&board, moves, 2);
+    max_board_make_null(&board);
+    ASSERT(max_board_side(&board) == MAX_SIDE_BLACK, "Null move does not pass the turn");
+    ASSERT(
+        !max_packed_state_has_ep(max_board_state(&board)->packed),
+        "En passant is still available after a null move"
+    );
+    ASSERT(max_board_state(&board)->position != before, "Zobrist key is not changed by a null move");
+    max_board_make_null(&board);
+    ASSERT(max_board_state(&board)->position == before, "Zobrist key after two null moves does not match the original");
+    max_board_unmake_null(&board);
+    max_board_unmake_null(&board);
+    ASSERT(
+        max_board_state(&board)->position == before && max_board_side(&board) == MAX_SIDE_WHITE,
+        "Unmaking a null move does not restore the original position"
+    );
+    ASSERT(max_board_perft(&board, moves, 2) == nodes, "Perft after unmaking a null move does not match the original");
 }
 
 
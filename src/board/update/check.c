@@ -4,8 +4,10 @@
 #include "max/board/move.h"
 #include "max/board/movegen/pawn.h"
 #include "max/board/piececode.h"
+#include "max/board/piecelist.h"
 #include "max/board/state.h"
 #include "private/board/board.h"
+#include "private/board/state.h"
 #include "private/board/movegen.h"
 #include "max/board/movegen/king.h"
 #include "private/board/movegen/knight.h"
@@ -129,6 +131,33 @@ void max_board_update_check(max_board_t *board, max_smove_t move) {
 #endif
 }
 
+void max_board_detect_check(max_board_t *board) {
+    max_state_t *state = max_board_state(board);
+    state->check[0] = max_check_empty();
+    state->check[1] = max_check_empty();
+
+    max_check_t *check = state->check;
+    max_0x88_t kpos = *max_board_side_list(board, max_board_side(board))->king.loc;
+    max_pieces_t *enemy = max_board_side_list(board, max_board_enemy_side(board));
+
+    max_loclist_t *lists[] = {
+        (max_loclist_t*)(&enemy->pawn),
+        (max_loclist_t*)(&enemy->knight),
+        (max_loclist_t*)(&enemy->bishop),
+        (max_loclist_t*)(&enemy->rook),
+        (max_loclist_t*)(&enemy->queen),
+    };
+
+    for(unsigned l = 0; l < sizeof(lists) / sizeof(lists[0]); ++l) {
+        for(unsigned i = 0; i < lists[l]->len; ++i) {
+            check = max_board_piece_delivers_check(board, kpos, lists[l]->loc[i], check);
+            if(check == state->check + 2) {
+                return;
+            }
+        }
+    }
+}
+
 static MAX_INLINE_ALWAYS bool max_board_attack_lookup(max_board_t *board, max_0x88_t pos, max_piececode_t mask) {
     return (max_0x88_valid(pos) && board->pieces[pos.v].v == mask.v);
 }
@@ -190,3 +219,66 @@ bool max_board_square_is_attacked(max_board_t *board, max_0x88_t pos) {
 
     return false;
 }
+
+/// Check if a piece standing next to the given square on the given ray may attack it without sliding
+static MAX_INLINE_ALWAYS bool max_board_attacks_adjacent(max_piececode_t piece, max_0x88_t from, max_0x88_t pos) {
+    switch(piece.v & MAX_PIECECODE_TYPE_MASK) {
+        case MAX_PIECECODE_KING: return true;
+        case MAX_PIECECODE_PAWN: {
+            max_0x88_t advanced = max_0x88_move(from, MAX_PAWN_ADVANCE_DIR[max_piececode_side(piece)]);
+            return
+                max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[0]).v == pos.v ||
+                max_0x88_move(advanced, MAX_PAWN_ATTACK_SIDES[1]).v == pos.v;
+        } break;
+
+        default: return false;
+    }
+}
+
+/// Add an attacker to the list, returning its index so that x-ray attackers behind it can refer to it
+static MAX_INLINE_ALWAYS uint8_t max_attackers_add(max_attackers_t *attackers, max_0x88_t loc, max_piececode_t piece, uint8_t behind) {
+    MAX_ASSERT(attackers->len < MAX_ATTACKERS_CAP);
+    attackers->buf[attackers->len] = (max_attacker_t){
+        .loc = loc,
+        .piece = piece,
+        .behind = behind,
+    };
+
+    return attackers->len++;
+}
+
+void max_board_attackers(max_board_t *board, max_0x88_t pos, max_attackers_t *attackers) {
+    attackers->len = 0;
+
+    for(unsigned i = 0; i < MAX_KNIGHT_MOVES_LEN; ++i) {
+        max_0x88_t from = max_0x88_move(pos, MAX_KNIGHT_MOVES[i]);
+        if(max_0x88_valid(from) && (board->pieces[from.v].v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_KNIGHT) {
+            max_attackers_add(attackers, from, board->pieces[from.v], MAX_ATTACKER_DIRECT);
+        }
+    }
+
+    //Walk each ray outwards, collecting pieces for as long as every piece found attacks the square once the pieces
+    //in front of it have captured
+    for(unsigned i = 0; i < MAX_0x88_RAYS_LEN; ++i) {
+        max_0x88_dir_t dir = MAX_0x88_RAYS[i];
+        max_piecemask_t sliders = max_0x88_piecemask_for_dir(dir);
+        uint8_t behind = MAX_ATTACKER_DIRECT;
+        bool adjacent = true;
+
+        for(max_0x88_t scan = max_0x88_move(pos, dir); max_0x88_valid(scan); scan = max_0x88_move(scan, dir)) {
+            max_piececode_t piece = board->pieces[scan.v];
+            if(piece.v != MAX_PIECECODE_EMPTY) {
+                if(
+                    !max_piececode_match(piece, sliders) &&
+                    !(adjacent && max_board_attacks_adjacent(piece, scan, pos))
+                ) {
+                    break;
+                }
+
+                behind = max_attackers_add(attackers, scan, piece, behind);
+            }
+
+            adjacent = false;
+        }
+    }
+}
@@ -10,6 +10,7 @@
 #include "private/board/movegen.h"
 #include "max/board/movegen/king.h"
 #include "private/board/state.h"
+#include "private/board/zobrist.h"
 
 
 void max_board_make_move(max_board_t *board, max_smove_t move) {
@@ -38,7 +39,9 @@ void max_board_make_move(max_board_t *board, max_smove_t move) {
             max_check_empty(),
             max_check_empty(),
         },
-        .position = old_state->position
+        .position = old_state->position ^ max_zobrist_side_element(&board->zobrist_state),
+        .pawns = old_state->pawns,
+        .material = old_state->material,
     };
     
     //Reset the en passant file from the previous packed state, but keep the castle rights
@@ -54,6 +57,9 @@ void max_board_make_move(max_board_t *board, max_smove_t move) {
         state.packed &= ~max_packed_state_hcastle(side);
     }
     
+    //Push the new state before shuffling any pieces so that the zobrist key of the previous ply is not modified
+    max_state_stack_push(&board->stack, state);
+
     //Shuffle the pieces as specified in the move
     if(move.tag & MAX_MOVETAG_CAPTURE) {
         max_piececode_t piece = max_board_remove_piece_from_side(board, enemy, move.to);
@@ -61,16 +67,14 @@ void max_board_make_move(max_board_t *board, max_smove_t move) {
         max_captures_add(&board->captures, piece);
 
         if(move.to.v == enemy->initial_rook[MAX_CASTLE_ASIDE].v) {
-            state.packed &= ~max_packed_state_acastle(enemy_side);
+            max_board_state(board)->packed &= ~max_packed_state_acastle(enemy_side);
         } else if(move.to.v == enemy->initial_rook[MAX_CASTLE_HSIDE].v) {
-            state.packed &= ~max_packed_state_hcastle(enemy_side);
+            max_board_state(board)->packed &= ~max_packed_state_hcastle(enemy_side);
         }
     } else {
         MAX_SANITY(board->pieces[move.to.v].v == MAX_PIECECODE_EMPTY);
     }
 
-    max_state_stack_push(&board->stack, state);
-
     switch(move.tag & ~MAX_MOVETAG_CAPTURE) {
         case MAX_MOVETAG_NONE: {
             max_board_move_piece_from_side(board, friendly, move.from, move.to);
@@ -150,3 +154,27 @@ void max_board_make_move(max_board_t *board, max_smove_t move) {
     //Increment the ply to indicate that the other side is now to move 
     max_board_update_check(board, move);
 }
+
+void max_board_make_null(max_board_t *board) {
+    max_state_t *old_state = max_board_state(board);
+    MAX_SANITY(max_check_is_empty(old_state->check[0]) && "Null move made while in check");
+
+    #ifdef MAX_ASSERTS_SANITY
+    old_state->move = max_smove_none();
+    #endif
+
+    //The side that passed cannot be giving check, and an en passant capture is only available directly after a double push
+    max_state_t state = (max_state_t){
+        .packed = max_packed_state_set_epfile(old_state->packed, MAX_FILE_INVALID),
+        .check = {
+            max_check_empty(),
+            max_check_empty(),
+        },
+        .position = old_state->position ^ max_zobrist_side_element(&board->zobrist_state),
+        .pawns = old_state->pawns,
+        .material = old_state->material,
+    };
+
+    max_state_stack_push(&board->stack, state);
+    board->ply += 1;
+}
@@ -79,3 +79,8 @@ void max_board_unmake_move(max_board_t *board, max_smove_t move) {
     //Pop from the state stack last because the prior operations may have modified the zobrist key
     max_state_stack_pop(&board->stack);
 }
+
+void max_board_unmake_null(max_board_t *board) {
+    board->ply -= 1;
+    max_state_stack_pop(&board->stack);
+}
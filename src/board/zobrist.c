@@ -62,4 +62,14 @@ void max_zobrist_elements_init(max_zobrist_elements_t *elems, uint64_t seed) {
     for(unsigned i = 0; i < 8; ++i) {
         elems->en_passant_file[i] = max_zobrist_rng(&state);
     }
+
+    elems->black_to_play = max_zobrist_rng(&state);
+
+    for(unsigned color = 0; color < MAX_SIDES_LEN; ++color) {
+        for(unsigned i = 0; i < MAX_PIECEINDEX_LEN; ++i) {
+            for(unsigned j = 0; j < MAX_ZOBRIST_MATERIAL_COUNT; ++j) {
+                elems->material[color][i][j] = max_zobrist_rng(&state);
+            }
+        }
+    }
 }
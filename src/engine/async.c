@@ -0,0 +1,111 @@
+#include "max/engine/engine.h"
+#include "max/board/board.h"
+#include "private/engine/search.h"
+
+#ifdef MAX_THREADS
+
+/// Entry point of the thread running a search started by max_engine_search_start()
+static int max_engine_async_main(void *data) {
+    max_engine_t *engine = (max_engine_t*)data;
+    max_engine_search_run(engine, &engine->async.limits, &engine->async.result);
+    atomic_store_explicit(&engine->async.done, true, memory_order_release);
+    return 0;
+}
+
+bool max_engine_search_start(max_engine_t *engine, max_search_limits_t const *limits, bool ponder) {
+    MAX_ASSERT(!engine->async.running && "Search started while another search is running");
+
+    //Flags are set before the thread is created so that a stop or ponder hit issued immediately after this returns
+    //is observed by the search
+    engine->async.limits = *limits;
+    engine->async.side = max_board_side(&engine->board);
+    atomic_store(&engine->async.done, false);
+    max_engine_flag_store(&engine->stop_signal, false);
+    max_engine_word_store(&engine->stop_time, 0);
+    max_engine_flag_store(&engine->ponder, ponder);
+
+    if(thrd_create(&engine->async.thread, max_engine_async_main, engine) != thrd_success) {
+        max_engine_flag_store(&engine->ponder, false);
+        return false;
+    }
+
+    engine->async.running = true;
+    return true;
+}
+
+bool max_engine_search_done(max_engine_t *engine) {
+    return atomic_load_explicit(&engine->async.done, memory_order_acquire);
+}
+
+void max_engine_search_wait(max_engine_t *engine, max_search_result_t *search) {
+    MAX_ASSERT(engine->async.running && "No search is running to wait for");
+    thrd_join(engine->async.thread, NULL);
+    engine->async.running = false;
+    max_engine_flag_store(&engine->ponder, false);
+    *search = engine->async.result;
+}
+
+void max_engine_ponderhit(max_engine_t *engine) {
+    uint64_t budget = max_engine_time_budget(&engine->async.limits, engine->async.side);
+    uint64_t deadline = (budget == UINT64_MAX) ? UINT64_MAX : max_engine_clock_ms() + budget;
+    max_engine_word_store(&engine->limits.deadline, deadline);
+    max_engine_flag_store(&engine->ponder, false);
+}
+
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "max/board/movegen.h"
+#include "private/engine/engine.h"
+#include "private/test.h"
+
+/// Check if the given move is legal in the position on the engine's board
+static bool max_engine_async_legal(max_engine_t *engine, max_smove_t move) {
+    max_movelist_t moves = max_movelist_slice(&engine->moves);
+    max_board_movegen_legal(&engine->board, &moves);
+    for(unsigned i = 0; i < moves.len; ++i) {
+        if(max_smove_eq(moves.buf[i], move)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void max_engine_async_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+    max_board_default_pos(&engine->board);
+    max_search_result_t result;
+
+    //A ponder search ignores its time limit until the ponder hit, after which it is given the time to finish
+    ASSERT(
+        max_engine_search_start(engine, &(max_search_limits_t){ .movetime = 10 }, true),
+        "Failed to start a ponder search"
+    );
+    thrd_sleep(&(struct timespec){ .tv_nsec = 50000000 }, NULL);
+    ASSERT(!max_engine_search_done(engine), "Ponder search finished before a ponder hit");
+    max_engine_ponderhit(engine);
+    max_engine_search_wait(engine, &result);
+    ASSERT(max_engine_async_legal(engine, result.best), "Ponder search does not return a legal move");
+    ASSERT(result.stop_latency == 0, "Ponder search that was not stopped reports a stop latency");
+
+    //A search without limits only finishes when stopped, and reports how long the stop took to take effect
+    ASSERT(
+        max_engine_search_start(engine, &(max_search_limits_t){0}, false),
+        "Failed to start an unlimited search"
+    );
+    thrd_sleep(&(struct timespec){ .tv_nsec = 20000000 }, NULL);
+    ASSERT(!max_engine_search_done(engine), "Unlimited search finished before it was stopped");
+    max_engine_stop(engine);
+    max_engine_search_wait(engine, &result);
+    ASSERT(max_engine_async_legal(engine, result.best), "Stopped search does not return a legal move");
+    ASSERT(
+        result.stop_latency > 0 && result.stop_latency < MAX_ENGINE_ASYNC_TEST_LATENCY_US,
+        "Stop latency of %llu us is not measured or exceeds %u us",
+        (unsigned long long)result.stop_latency,
+        MAX_ENGINE_ASYNC_TEST_LATENCY_US
+    );
+}
+
+#endif
+
+#endif
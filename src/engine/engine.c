@@ -12,349 +12,1087 @@
 #include "private/board/state.h"
 #include "private/engine/engine.h"
 #include "private/engine/eval.h"
+#include "private/engine/eval/endgame.h"
+#include "private/engine/eval/strategy.h"
+#include "private/engine/history.h"
+#include "private/engine/picker.h"
 #include "private/engine/search.h"
+#include "private/engine/see.h"
 #include "private/engine/tt.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
-#define TMP_TIME_CONTROL (10)
+uint8_t MAX_ENGINE_LMR[MAX_ENGINE_MAX_PLY][MAX_ENGINE_LMR_MOVES_LEN] = {{0}};
+
+void max_engine_init_static(void) {
+    for(unsigned depth = 1; depth < MAX_ENGINE_MAX_PLY; ++depth) {
+        for(unsigned movenum = 1; movenum < MAX_ENGINE_LMR_MOVES_LEN; ++movenum) {
+            MAX_ENGINE_LMR[depth][movenum] = (uint8_t)(0.5 + log(depth) * log(movenum) / 2.25);
+        }
+    }
+}
 
 void max_engine_new(max_engine_t *engine, max_engine_init_params_t *init, max_eval_params_t param) {
     MAX_ASSERT(init->board.capacity >= 3 && "Board state stack must be at least 3");
     max_board_new(&engine->board, init->board.stack, MAX_ZOBRIST_DEFAULT_SEED);
     max_ttbl_new(&engine->table, init->ttbl.buf, init->ttbl.nbit);
     max_movelist_new(&engine->moves, init->moves.buf, init->moves.capacity);
+    max_engine_heuristics_clear(&engine->heuristics);
+    engine->root_ply = 0;
+    engine->null_min_ply = 0;
+    engine->extensions = 0;
+    engine->seldepth = 0;
+    engine->multipv = 1;
     engine->param = param;
+    max_engine_psqt_build(&engine->psqt, &engine->param);
+    max_board_set_psqt(&engine->board, &engine->psqt);
+    max_engine_pawns_clear(engine);
+    max_engine_material_clear(engine);
+    max_engine_evalcache_clear(engine);
+    max_engine_set_info(engine, NULL, NULL, 0);
+
+    max_engine_flag_store(&engine->stop_signal, false);
+    max_engine_word_store(&engine->stop_time, 0);
+    max_engine_flag_store(&engine->ponder, false);
+    max_engine_word_store(&engine->limits.deadline, UINT64_MAX);
+    max_engine_word_store(&engine->progress.depth, 0);
+    max_engine_word_store(&engine->progress.nodes, 0);
+    engine->stop = &engine->stop_signal;
+
+    #ifdef MAX_THREADS
+    engine->threads.buf = init->threads.buf;
+    engine->threads.count = init->threads.count;
+    engine->threads.running = 0;
+    atomic_init(&engine->async.done, false);
+    engine->async.running = false;
+    #endif
 }
 
-max_score_t max_engine_quiesce(max_engine_t *engine, max_movelist_t moves, max_score_t alpha, max_score_t beta, uint8_t depth) {
-    max_score_t stand = max_engine_eval(engine);
-    if(stand >= beta) {
-        return beta;
+void max_engine_set_multipv(max_engine_t *engine, uint8_t count) {
+    if(count < 1) {
+        count = 1;
+    } else if(count > MAX_ENGINE_MULTIPV_MAX) {
+        count = MAX_ENGINE_MULTIPV_MAX;
     }
 
+    engine->multipv = count;
+}
 
-    if(stand > alpha) {
-        alpha = stand;
+uint64_t max_engine_clock_us(void) {
+    struct timespec now;
+    #ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    #else
+    timespec_get(&now, TIME_UTC);
+    #endif
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void max_engine_stop(max_engine_t *engine) {
+    //Only the first stop of a search is timed
+    #ifdef MAX_THREADS
+    uint64_t expected = 0;
+    atomic_compare_exchange_strong(&engine->stop_time, &expected, max_engine_clock_us());
+    #else
+    if(engine->stop_time == 0) {
+        engine->stop_time = max_engine_clock_us();
     }
+    #endif
+    max_engine_flag_store(&engine->stop_signal, true);
+}
 
-    if(depth == 0) {
-        return stand;
+max_search_progress_t max_engine_progress(max_engine_t *engine) {
+    return (max_search_progress_t){
+        .depth = (uint8_t)max_engine_word_load(&engine->progress.depth),
+        .nodes = max_engine_word_load(&engine->progress.nodes),
+    };
+}
+
+/// Check if the search must be stopped, either because a limit of the search has been exceeded or because
+/// the main search thread has finished and raised the stop flag shared with all helper threads.
+/// The clock and stop flag are only polled once every #MAX_ENGINE_POLL_INTERVAL calls from the move loops of interior
+/// nodes, and the result is latched so that every node above the one that noticed the stop returns without polling
+/// again.
+static bool max_engine_timeout(max_engine_t *engine) {
+    if(engine->limits.poll > 0) {
+        engine->limits.poll -= 1;
+        return engine->limits.stopped;
     }
 
-    max_board_movegen(&engine->board, &moves);
-    //max_engine_sortmoves(engine, moves);
-    for(unsigned i = 0; i < moves.len; ++i) {
-        max_smove_t move = moves.buf[i];
-        if((move.tag & MAX_MOVETAG_CAPTURE) != MAX_MOVETAG_CAPTURE || !max_board_legal(&engine->board, move)) {
-            continue;
+    engine->limits.poll = MAX_ENGINE_POLL_INTERVAL;
+    max_engine_word_store(&engine->progress.nodes, engine->nodes);
+
+    if(max_engine_flag_load(engine->stop) || engine->nodes >= engine->limits.nodes) {
+        engine->limits.stopped = true;
+    }
+
+    //Time limits do not apply while pondering, as the clock that is running belongs to the opponent
+    uint64_t now = max_engine_clock_ms();
+    if(
+        !max_engine_flag_load(&engine->ponder) &&
+        now >= max_engine_word_load(&engine->limits.deadline)
+    ) {
+        engine->limits.stopped = true;
+    }
+
+    max_engine_info_poll(engine, now);
+
+    return engine->limits.stopped;
+}
+
+uint64_t max_engine_time_budget(max_search_limits_t const *limits, max_side_t side) {
+    uint64_t budget = UINT64_MAX;
+    if(limits->movetime != 0) {
+        budget = limits->movetime;
+    }
+
+    uint64_t remaining = (side == MAX_SIDE_WHITE) ? limits->wtime : limits->btime;
+    uint64_t inc = (side == MAX_SIDE_WHITE) ? limits->winc : limits->binc;
+    if(remaining != 0) {
+        //Never plan to spend more than the clock holds after reserving time to send the move
+        uint64_t usable = (remaining > MAX_ENGINE_MOVE_OVERHEAD) ? remaining - MAX_ENGINE_MOVE_OVERHEAD : remaining / 2;
+        uint64_t allocated = remaining / MAX_ENGINE_MOVES_TO_GO + (inc * 3) / 4;
+        if(allocated > usable) {
+            allocated = usable;
         }
 
-        max_board_make_move(&engine->board, move);
-        max_score_t score = -max_engine_quiesce(engine, max_movelist_slice(&moves), -beta, -alpha, depth - 1);
-        max_board_unmake_move(&engine->board, move);
+        if(allocated < budget) {
+            budget = allocated;
+        }
+    }
+
+    return budget;
+}
+
+/// Check if a transposition table entry searched to a sufficient depth bounds the score of the current node outside
+/// of the window, or gives its exact score within the window.
+/// \param ply Distance of the node from the root, used to convert a stored mate score to the current root
+/// \param [out] score Filled with the score to return from the node if the entry causes a cutoff
+/// \return true if the node can return the score without searching
+static bool max_engine_probe_cutoff(
+    max_engine_t *engine,
+    max_ttentry_data_t probed,
+    uint8_t ply,
+    max_score_t alpha,
+    max_score_t beta,
+    max_score_t *score
+) {
+    (void)engine;
+    max_score_t probed_score = max_score_from_node(max_ttentry_data_score(probed), ply);
+    switch(max_ttentry_data_kind(probed)) {
+        case MAX_NODEKIND_PV: {
+            if(probed_score >= beta) {
+                *score = beta;
+                break;
+            }
+
+            if(probed_score >= alpha) {
+                *score = probed_score;
+                break;
+            }
+        } return false;
+
+        case MAX_NODEKIND_ALL: {
+            if(probed_score <= alpha) {
+                *score = alpha;
+                break;
+            }
+        } return false;
+
+        case MAX_NODEKIND_CUT: {
+            if(probed_score >= beta) {
+                *score = beta;
+                break;
+            }
+        } return false;
+
+        default: return false;
+    }
+
+    DIAGNOSTIC(engine->diagnostic.ttbl_used += 1);
+    return true;
+}
+
+/// Store the result of a search at the given distance from the root to the transposition table
+static MAX_INLINE_ALWAYS void max_engine_tt_store(max_engine_t *engine, max_zobrist_t hash, max_nodescore_t node, uint8_t ply) {
+    node.score = max_score_to_node(node.score, ply);
+    max_ttbl_probe_insert(&engine->table, hash, node);
+}
+
+/// Get the material captured by the given move, or 0 if it is not a capture
+static MAX_INLINE_ALWAYS max_score_t max_engine_captured_value(max_engine_t *engine, max_smove_t move) {
+    if(move.tag == MAX_MOVETAG_ENPASSANT) {
+        return engine->param.material.pawn;
+    }
+
+    if(move.tag & MAX_MOVETAG_CAPTURE) {
+        return max_engine_score_piece(engine, engine->board.pieces[move.to.v]);
+    }
+
+    return 0;
+}
+
+max_score_t max_engine_quiesce(max_engine_t *engine, max_movelist_t moves, max_score_t alpha, max_score_t beta) {
+    engine->nodes += 1;
+    uint8_t ply = engine->board.ply - engine->root_ply;
+    if(ply > engine->seldepth) {
+        engine->seldepth = ply;
+    }
 
-        if(score >= beta) {
+    //Captures run out long before this on any real line, but the per-ply storage of the search must not be exceeded
+    if(ply >= MAX_ENGINE_MAX_PLY) {
+        return max_engine_eval(engine);
+    }
+
+    max_zobrist_t hash = max_board_state(&engine->board)->position;
+    max_ttentry_data_t probed;
+    max_smove_t ttmove = max_smove_none();
+    if(max_ttbl_probe_read(&engine->table, hash, &probed)) {
+        DIAGNOSTIC(engine->diagnostic.ttbl_hits += 1);
+        ttmove = max_ttentry_data_move(probed);
+
+        max_score_t cutoff;
+        if(max_engine_probe_cutoff(engine, probed, ply, alpha, beta, &cutoff)) {
+            return cutoff;
+        }
+    }
+
+    max_nodescore_t node = (max_nodescore_t){
+        .bestmove = ttmove,
+        .score = alpha,
+        .kind = MAX_NODEKIND_ALL,
+        .depth = 0,
+    };
+
+    //A side in check may not stand pat, and must search every evasion to prove that it is not mated
+    bool in_check = max_check_has_value(max_board_state(&engine->board)->check[0]);
+    max_score_t stand = MAX_SCORE_LOWEST;
+    if(!in_check) {
+        stand = max_engine_eval(engine);
+        if(stand >= beta) {
+            node.score = beta;
+            node.kind = MAX_NODEKIND_CUT;
+            max_engine_tt_store(engine, hash, node, ply);
             return beta;
         }
 
+        //Not even capturing a queen for free could raise alpha
+        if(stand + engine->param.material.queen + MAX_ENGINE_DELTA_MARGIN <= alpha) {
+            return alpha;
+        }
+
+        if(stand > alpha) {
+            alpha = stand;
+            node.score = stand;
+            node.kind = MAX_NODEKIND_PV;
+        }
+    }
+
+    //The picker yields every evasion when in check, otherwise only the captures and promotions that do not lose
+    //material by static exchange
+    max_picker_t picker;
+    max_picker_new_tactical(&picker, moves, ttmove);
+
+    uint8_t legal_count = 0;
+    max_smove_t move;
+    while(max_picker_next(&picker, engine, &move)) {
+        //Captures that cannot raise alpha even if the captured piece is won for free are pruned
+        if(
+            !in_check &&
+            !max_movetag_is_promote(move.tag) &&
+            stand + max_engine_captured_value(engine, move) + MAX_ENGINE_DELTA_MARGIN <= alpha
+        ) {
+            continue;
+        }
+
+        legal_count += 1;
+        max_engine_make_move(engine, move);
+        max_score_t score = -max_engine_quiesce(engine, max_movelist_slice(&picker.moves), -beta, -alpha);
+        max_board_unmake_move(&engine->board, move);
+
         if(score > alpha) {
+            node.bestmove = move;
+            node.kind = MAX_NODEKIND_PV;
+            node.score = score;
             alpha = score;
+
+            if(score >= beta) {
+                node.score = beta;
+                node.kind = MAX_NODEKIND_CUT;
+                break;
+            }
+        }
+    }
+
+    if(in_check && legal_count == 0) {
+        node.score = max_score_mated(ply);
+        node.kind = MAX_NODEKIND_PV;
+    }
+
+    max_engine_tt_store(engine, hash, node, ply);
+    return node.score;
+}
+
+
+/// Search a single child of the current node with principal variation search.
+/// Moves after the first are searched with a null window that only proves they are no better than alpha,
+/// and are re-searched with the full window if that proof fails.
+/// Late quiet moves are first searched at a reduced depth, and only searched at full depth if the reduced search
+/// raises alpha.
+/// \param first true if this is the first move searched from the current node, which is searched with the full window
+/// \param reduction Depth to reduce the null window search by, ignored if the move gives check
+/// \param [out] score Filled with the score of the child from the perspective of the side to play at the current node
+static max_engine_stop_t max_engine_negamax_child(
+    max_engine_t *engine,
+    max_movelist_t moves,
+    max_smove_t move,
+    max_score_t alpha,
+    max_score_t beta,
+    bool first,
+    uint8_t reduction,
+    uint8_t depth,
+    max_score_t *score
+) {
+    max_nodescore_t node;
+    max_engine_make_move(engine, move);
+
+    //Checking moves are forcing and are never reduced, and are searched a ply deeper until the line has been extended
+    //too many times
+    uint8_t extension = 0;
+    if(max_check_has_value(max_board_state(&engine->board)->check[0])) {
+        reduction = 0;
+        if(engine->extensions < MAX_ENGINE_CHECK_EXTENSIONS) {
+            extension = 1;
+        }
+    }
+
+    uint8_t child = depth - 1 + extension;
+    engine->extensions += extension;
+
+    max_engine_stop_t stop;
+    if(first) {
+        stop = max_engine_negamax(engine, max_movelist_slice(&moves), -beta, -alpha, &node, child);
+    } else {
+        stop = max_engine_negamax(engine, max_movelist_slice(&moves), -alpha - 1, -alpha, &node, child - reduction);
+        if(stop == MAX_ENGINE_STOP_SEARCH_DONE && reduction > 0 && -node.score > alpha) {
+            stop = max_engine_negamax(engine, max_movelist_slice(&moves), -alpha - 1, -alpha, &node, child);
+        }
+
+        if(stop == MAX_ENGINE_STOP_SEARCH_DONE && -node.score > alpha && -node.score < beta) {
+            stop = max_engine_negamax(engine, max_movelist_slice(&moves), -beta, -alpha, &node, child);
+        }
+    }
+
+    engine->extensions -= extension;
+    max_board_unmake_move(&engine->board, move);
+    *score = -node.score;
+    return stop;
+}
+
+/// Update the score of the current node after searching a child, raising alpha if the child improved it.
+/// \return true if the child caused a beta cutoff and no more children need to be searched
+static bool max_engine_negamax_update(max_nodescore_t *node, max_smove_t move, max_score_t child, max_score_t *alpha, max_score_t beta) {
+    if(child <= node->score) {
+        return false;
+    }
+
+    node->score = child;
+    if(child > *alpha) {
+        node->bestmove = move;
+        node->kind = MAX_NODEKIND_PV;
+        *alpha = child;
+        if(child >= beta) {
+            node->kind = MAX_NODEKIND_CUT;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Check if the given move gives check by making it on the board
+static bool max_engine_gives_check(max_engine_t *engine, max_smove_t move) {
+    max_board_make_move(&engine->board, move);
+    bool check = max_check_has_value(max_board_state(&engine->board)->check[0]);
+    max_board_unmake_move(&engine->board, move);
+    return check;
+}
+
+/// Begin an empty principal variation at the given ply
+static void max_engine_pv_clear(max_engine_t *engine, uint8_t ply) {
+    if(ply < MAX_ENGINE_MAX_PLY) {
+        engine->pv.len[ply] = ply;
+    }
+}
+
+/// Set the principal variation of the given ply to a move that raised alpha followed by the principal variation
+/// of the child that the move led to
+static void max_engine_pv_update(max_engine_t *engine, uint8_t ply, max_smove_t move) {
+    if(ply >= MAX_ENGINE_MAX_PLY) {
+        return;
+    }
+
+    max_engine_pv_t *pv = &engine->pv;
+    pv->line[ply][ply] = move;
+    pv->len[ply] = ply + 1;
+
+    if(ply + 1 < MAX_ENGINE_MAX_PLY) {
+        for(uint8_t i = ply + 1; i < pv->len[ply + 1]; ++i) {
+            pv->line[ply][i] = pv->line[ply + 1][i];
+        }
+
+        if(pv->len[ply + 1] > pv->len[ply]) {
+            pv->len[ply] = pv->len[ply + 1];
         }
     }
-    
-    return alpha;
 }
 
+/// Get the move played at the given ply by the principal variation of the last iteration, if the current line
+/// has followed that variation so far, or a placeholder once the search has left it
+static max_smove_t max_engine_pv_follow(max_engine_t *engine, uint8_t ply) {
+    if(engine->pv.following && ply < engine->pv.follow_len) {
+        return engine->pv.follow[ply];
+    }
+
+    engine->pv.following = false;
+    return max_smove_none();
+}
+
+/// Check if a null move may be tried from the current node, which must not be in check.
+/// In pawn endgames zugzwang is common enough that a null move
+/// will often fail high in a position that is lost for the side to play.
+/// Consecutive null moves are never searched as they would only return to the same position at a lower depth.
+static bool max_engine_null_allowed(max_engine_t *engine, uint8_t ply, max_score_t alpha, max_score_t beta, uint8_t depth) {
+    if(depth < MAX_ENGINE_NULL_MIN_DEPTH || ply == 0 || ply >= MAX_ENGINE_MAX_PLY || ply < engine->null_min_ply) {
+        return false;
+    }
+
+    //Only zero window nodes are pruned so that the principal variation is always searched in full
+    if(beta - alpha > 1 || max_score_is_mate(beta)) {
+        return false;
+    }
+
+    if(max_smove_is_none(engine->heuristics.stack[ply - 1].move)) {
+        return false;
+    }
+
+    max_pieces_t *pieces = max_board_side_list(&engine->board, max_board_side(&engine->board));
+    if(pieces->knight.len + pieces->bishop.len + pieces->rook.len + pieces->queen.len == 0) {
+        return false;
+    }
+
+    return max_engine_eval(engine) >= beta;
+}
+
+/// Pass the turn and search the resulting position with a reduced zero window around beta.
+/// If the side to play still fails high after giving the opponent a free move, the node is very likely to fail high
+/// with a real move and is pruned.
+/// \param [out] cutoff Set to true if the node can be pruned
+static max_engine_stop_t max_engine_null_prune(
+    max_engine_t *engine,
+    max_movelist_t moves,
+    max_score_t beta,
+    uint8_t ply,
+    uint8_t depth,
+    bool *cutoff
+) {
+    uint8_t reduced = depth - 1 - max_engine_null_reduction(depth);
+    max_nodescore_t node;
+    *cutoff = false;
+
+    engine->heuristics.stack[ply].move = max_smove_none();
+    max_board_make_null(&engine->board);
+    max_ttbl_prefetch(&engine->table, max_board_state(&engine->board)->position);
+    max_engine_stop_t stop = max_engine_negamax(engine, moves, -beta, -beta + 1, &node, reduced);
+    max_board_unmake_null(&engine->board);
+
+    if(stop == MAX_ENGINE_STOP_TIMECONTROL || -node.score < beta) {
+        return stop;
+    }
+
+    //Deep cutoffs are verified by searching the node itself at reduced depth with null moves disabled in the subtree,
+    //as the cost of pruning a zugzwang position there is far greater than the cost of the verification search
+    if(depth >= MAX_ENGINE_NULL_VERIFY_DEPTH) {
+        uint8_t min_ply = engine->null_min_ply;
+        engine->null_min_ply = ply + reduced + 1;
+        stop = max_engine_negamax(engine, moves, beta - 1, beta, &node, reduced + 1);
+        engine->null_min_ply = min_ply;
+
+        if(stop == MAX_ENGINE_STOP_TIMECONTROL || node.score < beta) {
+            return stop;
+        }
+    }
+
+    *cutoff = true;
+    return MAX_ENGINE_STOP_SEARCH_DONE;
+}
 
 max_engine_stop_t max_engine_negamax(max_engine_t *engine, max_movelist_t moves, max_score_t alpha, max_score_t beta, max_nodescore_t *score, uint8_t depth) {
+    uint8_t ply = engine->board.ply - engine->root_ply;
+    max_engine_pv_clear(engine, ply);
+    max_smove_t pvmove = max_engine_pv_follow(engine, ply);
+
     if(depth == 0) {
-        score->score = max_engine_quiesce(engine, moves, alpha, beta, 3);
+        score->score = max_engine_quiesce(engine, moves, alpha, beta);
         return MAX_ENGINE_STOP_SEARCH_DONE;
     }
 
+    engine->nodes += 1;
+
     if(max_board_threefold(&engine->board)) {
-        puts("THREEFOLD REPETITION");
         score->score = 0;
         return MAX_ENGINE_STOP_SEARCH_DONE;
     }
 
-    max_zobrist_t hash = max_board_state(&engine->board)->position;
-    max_ttentry_t const *probed = max_ttbl_probe_read(&engine->table, hash);
+    //No line from this node can be better than mating on the next ply or worse than being mated on this one,
+    //so the node is already decided if a shorter mate has been found elsewhere
+    if(alpha < max_score_mated(ply)) {
+        alpha = max_score_mated(ply);
+    }
 
-    if(probed != NULL && probed->depth >= depth) {
-        DIAGNOSTIC(engine->diagnostic.ttbl_hits += 1);
-        switch(probed->attr & MAX_TTENTRY_PATTR_KIND_MASK) {
-            case (MAX_NODEKIND_PV << MAX_TTENTRY_PATTR_KIND_POS): {
-                if(probed->score >= beta) {
-                    DIAGNOSTIC(engine->diagnostic.ttbl_used += 1);
-                    score->score = beta;
-                    return MAX_ENGINE_STOP_SEARCH_DONE;
-                }
+    if(beta > -max_score_mated(ply + 1)) {
+        beta = -max_score_mated(ply + 1);
+    }
 
-                if(probed->score >= alpha && probed->score < beta) {
-                    DIAGNOSTIC(engine->diagnostic.ttbl_used += 1);
-                    score->score = probed->score;
-                    return MAX_ENGINE_STOP_SEARCH_DONE;
-                }
-            } break;
+    if(alpha >= beta) {
+        score->score = alpha;
+        return MAX_ENGINE_STOP_SEARCH_DONE;
+    }
 
-            case (MAX_NODEKIND_ALL << MAX_TTENTRY_PATTR_KIND_POS): {
-                if(probed->score <= alpha) {
-                    DIAGNOSTIC(engine->diagnostic.ttbl_used += 1);
-                    score->score = alpha;
-                    return MAX_ENGINE_STOP_SEARCH_DONE;
-                }
+    max_zobrist_t hash = max_board_state(&engine->board)->position;
+    max_ttentry_data_t probed;
+    max_smove_t ttmove = max_smove_none();
 
-                
-            } break;
+    if(max_ttbl_probe_read(&engine->table, hash, &probed)) {
+        DIAGNOSTIC(engine->diagnostic.ttbl_hits += 1);
+        ttmove = max_ttentry_data_move(probed);
 
-            case (MAX_NODEKIND_CUT << MAX_TTENTRY_PATTR_KIND_POS): {
-                if(probed->score >= beta) {
-                    DIAGNOSTIC(engine->diagnostic.ttbl_used += 1);
-                    score->score = beta;
-                    return MAX_ENGINE_STOP_SEARCH_DONE;
-                }
-            } break;
+        if(max_ttentry_data_depth(probed) >= depth && max_engine_probe_cutoff(engine, probed, ply, alpha, beta, &score->score)) {
+            return MAX_ENGINE_STOP_SEARCH_DONE;
         }
     }
 
+    //Keep the hash move for all nodes that fail to find a better move so that it is not lost when the entry is replaced
     *score = (max_nodescore_t){
+        .bestmove = ttmove,
         .score = MAX_SCORE_LOWEST + 20,
         .kind = MAX_NODEKIND_ALL,
         .depth = depth,
     };
 
-    max_board_movegen(&engine->board, &moves);
-    max_engine_sortmoves(engine, moves);
-    
     uint8_t legal_count = 0;
-   
-    max_smove_t first = moves.buf[0];
-    if(max_board_legal(&engine->board, first)) {
-        legal_count += 1;
-        max_board_make_move(&engine->board, first);
-        max_engine_negamax(engine, max_movelist_slice(&moves), -beta, -alpha, score, depth - 1);
-        score->score = -score->score;
-        max_board_unmake_move(&engine->board, first);
-        if(score->score >= beta) {
-            score->kind = MAX_NODEKIND_CUT;
+    if(ply > engine->seldepth) {
+        engine->seldepth = ply;
+    }
+
+    max_engine_ply_t *frame = (ply < MAX_ENGINE_MAX_PLY) ? &engine->heuristics.stack[ply] : NULL;
+    bool in_check = max_check_has_value(max_board_state(&engine->board)->check[0]);
+
+    //Frontier nodes of a zero window search are pruned by their static evaluation when it lies far outside the window
+    bool futile = false;
+    if(
+        !in_check &&
+        depth <= MAX_ENGINE_PRUNE_DEPTH &&
+        beta - alpha == 1 &&
+        !max_score_is_mate(alpha) &&
+        !max_score_is_mate(beta)
+    ) {
+        max_engine_prune_param_t const *prune = &engine->param.prune;
+        max_score_t eval = max_engine_eval(engine);
+        if(eval - prune->reverse_futility[depth] >= beta) {
+            score->score = eval;
             return MAX_ENGINE_STOP_SEARCH_DONE;
         }
 
-        alpha = score->score;
+        if(eval + prune->razor[depth] <= alpha) {
+            max_score_t razored = max_engine_quiesce(engine, moves, alpha, beta);
+            if(depth == 1 || razored <= alpha) {
+                score->score = razored;
+                return MAX_ENGINE_STOP_SEARCH_DONE;
+            }
+        }
+
+        futile = eval + prune->futility[depth] <= alpha;
     }
 
-    for(unsigned i = 1; i < moves.len; ++i) {
-        if(time(NULL) - engine->time >= TMP_TIME_CONTROL) {
+    if(!in_check && max_engine_null_allowed(engine, ply, alpha, beta, depth)) {
+        bool cutoff;
+        if(max_engine_null_prune(engine, moves, beta, ply, depth, &cutoff) == MAX_ENGINE_STOP_TIMECONTROL) {
             return MAX_ENGINE_STOP_TIMECONTROL;
         }
 
-        max_smove_t move = moves.buf[i];
-        if(!max_board_legal(&engine->board, move)) {
-            continue;
+        if(cutoff) {
+            score->score = beta;
+            score->kind = MAX_NODEKIND_CUT;
+            return MAX_ENGINE_STOP_SEARCH_DONE;
         }
+    }
 
-        legal_count += 1;
-        
-        max_nodescore_t node;
-        max_board_make_move(&engine->board, move);
-        max_engine_stop_t stop = max_engine_negamax(engine, max_movelist_slice(&moves), -alpha - 1, -alpha, &node, depth - 1);
-        if(stop == MAX_ENGINE_STOP_TIMECONTROL) {
-            max_board_unmake_move(&engine->board, move);
+    //Quiet moves that failed to cause a cutoff, penalized in the history table if a later quiet move does
+    max_smove_t quiets[MAX_ENGINE_HISTORY_QUIETS_CAP];
+    uint8_t quiets_len = 0;
+
+    //The hash move is yielded before any moves are generated, and will often cause a cutoff by itself.
+    //Along the principal variation of the last iteration, its move takes the place of the hash move
+    max_picker_t picker;
+    max_picker_new(
+        &picker,
+        moves,
+        max_smove_is_none(pvmove) ? ttmove : pvmove,
+        (frame != NULL) ? frame->killers : NULL,
+        (frame != NULL) ? max_engine_countermove(&engine->heuristics, ply) : max_smove_none()
+    );
+
+    max_smove_t move;
+    while(max_picker_next(&picker, engine, &move)) {
+        if(legal_count > 0 && max_engine_timeout(engine)) {
             return MAX_ENGINE_STOP_TIMECONTROL;
         }
-        node.score = -node.score;
 
+        //Quiet moves of a futile node cannot recover the deficit unless they give check
+        if(futile && legal_count > 0 && !max_picker_is_tactical(move) && !max_engine_gives_check(engine, move)) {
+            continue;
+        }
+
+        legal_count += 1;
+        if(frame != NULL) {
+            frame->move = move;
+        }
 
-         if(node.score > alpha && node.score < beta) {
-            if(max_engine_negamax(engine, max_movelist_slice(&moves), -beta, -alpha, &node, depth - 1) == MAX_ENGINE_STOP_TIMECONTROL) {
+        engine->pv.following = engine->pv.following && max_smove_eq(move, pvmove);
 
-                max_board_unmake_move(&engine->board, move);
-                return MAX_ENGINE_STOP_TIMECONTROL;
+        //Quiet moves ordered after the refutations are searched at reduced depth, less so in the principal variation
+        uint8_t reduction = 0;
+        if(
+            depth >= MAX_ENGINE_LMR_MIN_DEPTH &&
+            legal_count > MAX_ENGINE_LMR_MIN_MOVES &&
+            !in_check &&
+            picker.stage == MAX_PICKER_STAGE_QUIETS &&
+            !max_picker_is_tactical(move)
+        ) {
+            reduction = max_engine_lmr_reduction(depth, legal_count);
+            if(beta - alpha > 1 && reduction > 0) {
+                reduction -= 1;
             }
-            node.score = -node.score;
-            if(node.score > alpha) {
-                alpha = node.score;
+
+            if(reduction > depth - 2) {
+                reduction = depth - 2;
             }
         }
+        
+        max_score_t child;
+        if(max_engine_negamax_child(engine, picker.moves, move, alpha, beta, legal_count == 1, reduction, depth, &child) == MAX_ENGINE_STOP_TIMECONTROL) {
+            return MAX_ENGINE_STOP_TIMECONTROL;
+        }
 
-        max_board_unmake_move(&engine->board, move);
-        if(node.score > score->score) {
-            score->score = node.score;
-            if(node.score >= beta) {
-                score->kind = MAX_NODEKIND_CUT;
-                break;
-            }
+        if(child > alpha) {
+            max_engine_pv_update(engine, ply, move);
+        }
+
+        if(max_engine_negamax_update(score, move, child, &alpha, beta)) {
+            DIAGNOSTIC(
+                if(picker.stage == MAX_PICKER_STAGE_GENERATE) {
+                    engine->diagnostic.ttbl_cutoffs += 1;
+                }
+            );
 
-            if(node.score == alpha) {
-                score->kind = MAX_NODEKIND_PV;
+            if(!max_picker_is_tactical(move)) {
+                max_engine_heuristics_cutoff(
+                    &engine->heuristics,
+                    ply,
+                    max_board_side(&engine->board),
+                    move,
+                    quiets,
+                    quiets_len,
+                    depth
+                );
             }
+            break;
+        }
+
+        if(!max_picker_is_tactical(move) && quiets_len < MAX_ENGINE_HISTORY_QUIETS_CAP) {
+            quiets[quiets_len] = move;
+            quiets_len += 1;
         }
     }
 
     if(legal_count == 0) {
         if(!max_check_is_empty(max_board_state(&engine->board)->check[0])) {
-            score->score = -20000 - depth;
+            score->score = max_score_mated(ply);
         } else {
             score->score = -depth;
         }
     }
 
-    max_ttbl_probe_insert(
-        &engine->table,
-        hash,
-        *score,
-        engine->board.ply
-    );
+    max_engine_tt_store(engine, hash, *score, ply);
 
     return MAX_ENGINE_STOP_SEARCH_DONE;
+}
 
+/// Check if the given root move begins one of the lines before the given line of a multi-PV search
+static bool max_engine_root_excluded(max_search_result_t const *search, uint8_t line, max_smove_t move) {
+    for(uint8_t i = 0; i < line; ++i) {
+        if(search->lines[i].pv_len > 0 && max_smove_eq(search->lines[i].pv[0], move)) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-max_engine_stop_t max_engine_search_moves(max_engine_t *engine, max_scorelist_t *scored_moves, max_search_result_t *search, uint8_t depth) {
-    if(max_board_threefold(&engine->board)) {
+/// Search every root move within the given window, moving the best move to the front of the list for the next iteration.
+/// The given line of the search result is updated with every move that raises alpha, so that a partially searched
+/// iteration still reports the best move proven so far.
+/// Root moves beginning any earlier line of a multi-PV search are skipped, so that each line begins with a different move.
+/// \param line Index of the line in max_search_result_t::lines to search
+/// \param [out] score Filled with the best score of any root move, which is an upper bound if it is not above alpha
+/// and a lower bound if it is not below beta
+static max_engine_stop_t max_engine_search_moves(
+    max_engine_t *engine,
+    max_scorelist_t *scored_moves,
+    max_search_result_t *search,
+    uint8_t line,
+    max_score_t alpha,
+    max_score_t beta,
+    uint8_t depth,
+    max_score_t *score
+) {
+    if(max_board_threefold(&engine->board) || scored_moves->moves.len == 0) {
         return MAX_ENGINE_STOP_GAMEOVER;
     }
 
     max_scorelist_sort(scored_moves);
-    uint8_t nlegal = 0;
+    *score = MAX_SCORE_LOWEST;
 
-    uint8_t moves_to_search = scored_moves->moves.len;
-    uint8_t reduced = 20 - depth;
-    if(depth >= 5 && moves_to_search >= reduced) {
-        //moves_to_search = reduced;
+    //Replay the principal variation of the last iteration first, which was sorted to the front of the root moves
+    max_search_line_t *result = &search->lines[line];
+    for(uint8_t i = 0; i < result->pv_len; ++i) {
+        engine->pv.follow[i] = result->pv[i];
     }
 
-    for(unsigned i = 0; i < moves_to_search; ++i) {
+    engine->pv.follow_len = result->pv_len;
+
+    bool first = true;
+    for(unsigned i = 0; i < scored_moves->moves.len; ++i) {
         max_smove_t move = scored_moves->moves.buf[i];
-        if(!max_board_legal(&engine->board, move)) {
-            if(moves_to_search < scored_moves->moves.len) {
-                moves_to_search += 1;
-            }
+        if(line > 0 && max_engine_root_excluded(search, line, move)) {
             continue;
         }
 
-        nlegal += 1;
-        if(time(NULL) - engine->time >= TMP_TIME_CONTROL) {
-            return MAX_ENGINE_STOP_SEARCH_DONE;
+        engine->heuristics.stack[0].move = move;
+        if(max_engine_timeout(engine)) {
+            return MAX_ENGINE_STOP_TIMECONTROL;
         }
 
-        max_board_make_move(&engine->board, move);
+        engine->pv.following = result->pv_len > 0 && max_smove_eq(move, result->pv[0]);
+        max_engine_make_move(engine, move);
         max_nodescore_t node;
-        if(max_engine_negamax(
-            engine,
-            max_movelist_slice(&scored_moves->moves),
-            MAX_SCORE_LOWEST + 20,
-            MAX_SCORE_HIGHEST - 20,
-            &node,
-            depth - 1
-        ) == MAX_ENGINE_STOP_TIMECONTROL) {
-            max_board_unmake_move(&engine->board, move);
+        max_movelist_t child_moves = max_movelist_slice(&scored_moves->moves);
+        
+        //The first move is expected to be best and is searched with the full window, the rest only need to be proven worse
+        max_engine_stop_t stop;
+        if(first) {
+            stop = max_engine_negamax(engine, child_moves, -beta, -alpha, &node, depth - 1);
+        } else {
+            stop = max_engine_negamax(engine, child_moves, -alpha - 1, -alpha, &node, depth - 1);
+            if(stop == MAX_ENGINE_STOP_SEARCH_DONE && -node.score > alpha && -node.score < beta) {
+                stop = max_engine_negamax(engine, child_moves, -beta, -alpha, &node, depth - 1);
+            }
+        }
+
+        max_board_unmake_move(&engine->board, move);
+        if(stop == MAX_ENGINE_STOP_TIMECONTROL) {
             return MAX_ENGINE_STOP_TIMECONTROL;
         }
 
-        node.score = -node.score;
+        first = false;
+        max_score_t child = -node.score;
+        if(child > *score) {
+            *score = child;
+        }
 
-        //printf("%c%c%c%c @ %d - depth %u\n", MAX_0x88_FORMAT(move.from), MAX_0x88_FORMAT(move.to), node.score, depth);
-        max_board_unmake_move(&engine->board, move);
-        max_scorelist_score(scored_moves, i, node.score);
+        //Moves that fail low only have an upper bound, so they keep their relative order from the last iteration
+        //behind every move that raised alpha
+        if(child <= alpha) {
+            max_scorelist_score(scored_moves, i, MAX_SCORE_LOWEST);
+            continue;
+        }
+
+        max_scorelist_score(scored_moves, i, child);
+        max_engine_pv_update(engine, 0, move);
+        result->score = child;
+        result->pv_len = engine->pv.len[0];
+        for(uint8_t j = 0; j < result->pv_len; ++j) {
+            result->pv[j] = engine->pv.line[0][j];
+        }
 
-        if(node.score + depth * 20 > search->score + search->depth * 20 || (move.from.v == search->best.from.v && move.to.v == search->best.to.v)) {
+        if(line == 0) {
             search->best = move;
-            search->score = node.score;
-            search->depth = depth;
+            search->score = child;
         }
-    }
 
-    
-    if(nlegal == 0) {
-        if(!max_check_is_empty(max_board_state(&engine->board)->check[0])) {
-            return MAX_ENGINE_STOP_GAMEOVER;
+        alpha = child;
+
+        if(child >= beta) {
+            break;
         }
     }
 
     return MAX_ENGINE_STOP_SEARCH_DONE;
 }
 
-void max_engine_search(max_engine_t *engine, max_search_result_t *search) {
-    DIAGNOSTIC(
-        engine->diagnostic = (max_engine_diagnostic_t){
-            .nodes = 0,
-            .ttbl_hits = 0,
-            .ttbl_used = 0,
+/// Sort the lines of a completed multi-PV iteration by score, as a later line searched with a different window may
+/// find a better score than an earlier line, and set the best move of the search to the first line.
+static void max_engine_sort_lines(max_search_result_t *search, uint8_t len) {
+    MAX_ASSERT(len > 0 && "Lines sorted for a root without legal moves");
+    for(uint8_t i = 1; i < len; ++i) {
+        max_search_line_t line = search->lines[i];
+        uint8_t j = i;
+        while(j > 0 && search->lines[j - 1].score < line.score) {
+            search->lines[j] = search->lines[j - 1];
+            j -= 1;
         }
-    );
 
-    search->score = MAX_SCORE_LOWEST;
-    search->gameover = false;
-    max_state_stack_lower_head(&engine->board.stack, 3);
-    max_movelist_t moves = max_movelist_slice(&engine->moves);
+        search->lines[j] = line;
+    }
+
+    search->best = search->lines[0].pv[0];
+    search->score = search->lines[0].score;
+}
+
+/// Search a single line of an iterative deepening iteration with an aspiration window.
+/// \param line Index of the line in max_search_result_t::lines to search
+/// \param aspirate true to search within a narrow window around the score of the line from the last iteration
+static max_engine_stop_t max_engine_search_line(
+    max_engine_t *engine,
+    max_scorelist_t *scored_moves,
+    max_search_result_t *search,
+    uint8_t line,
+    uint8_t depth,
+    bool aspirate
+) {
+    //Search within a narrow window around the score of the last iteration, which is widened in the direction
+    //of any failure until the score is found to lie inside it
+    max_score_t last = search->lines[line].score;
+    int32_t delta = MAX_ENGINE_ASPIRATION_WINDOW;
+    int32_t alpha = MAX_ENGINE_WINDOW_LOWEST;
+    int32_t beta = MAX_ENGINE_WINDOW_HIGHEST;
+    if(aspirate && !max_score_is_mate(last) && last > MAX_ENGINE_WINDOW_LOWEST) {
+        alpha = last - delta;
+        beta = last + delta;
+    }
 
-    max_board_movegen(&engine->board, &moves);
+    for(;;) {
+        alpha = (alpha < MAX_ENGINE_WINDOW_LOWEST) ? MAX_ENGINE_WINDOW_LOWEST : alpha;
+        beta = (beta > MAX_ENGINE_WINDOW_HIGHEST) ? MAX_ENGINE_WINDOW_HIGHEST : beta;
+
+        max_score_t score;
+        max_engine_stop_t stop = max_engine_search_moves(engine, scored_moves, search, line, alpha, beta, depth, &score);
+        if(stop != MAX_ENGINE_STOP_SEARCH_DONE) {
+            return stop;
+        }
+
+        if(score <= alpha && alpha > MAX_ENGINE_WINDOW_LOWEST) {
+            beta = (alpha + beta) / 2;
+            alpha = score - delta;
+        } else if(score >= beta && beta < MAX_ENGINE_WINDOW_HIGHEST) {
+            beta = score + delta;
+        } else {
+            return MAX_ENGINE_STOP_SEARCH_DONE;
+        }
+
+        delta *= 2;
+    }
+}
+
+void max_engine_iterate(max_engine_t *engine, max_search_result_t *search, uint8_t start_depth) {
+    max_movelist_t moves = max_movelist_slice(&engine->moves);
+    max_board_movegen_legal(&engine->board, &moves);
     
+    //A root without legal moves or already drawn by repetition has no lines to search
+    if(moves.len == 0 || max_board_threefold(&engine->board)) {
+        search->gameover = true;
+        return;
+    }
+
     max_scorelist_t scored_moves;
     max_scorelist_reset(&scored_moves, moves);
+    for(uint16_t i = 0; i < moves.len; ++i) {
+        max_scorelist_score(&scored_moves, i, MAX_SCORE_LOWEST);
+    }
+
+    uint8_t multipv = (engine->multipv < moves.len) ? engine->multipv : (uint8_t)moves.len;
+    for(uint8_t line = 0; line < multipv; ++line) {
+        search->lines[line].score = MAX_SCORE_LOWEST;
+        search->lines[line].pv_len = 0;
+    }
+
+    //Always have a legal move to play, even if the search is stopped before the first iteration completes
+    if(max_smove_is_none(search->best)) {
+        search->best = moves.buf[0];
+        search->lines[0].pv[0] = search->best;
+        search->lines[0].pv_len = 1;
+        search->lines_len = 1;
+    }
 
-    engine->time = time(NULL);
-    for(uint8_t depth = 2; ; depth += 1) {
-        if(time(NULL) - engine->time >= TMP_TIME_CONTROL) {
+    for(uint8_t depth = start_depth; depth <= engine->limits.depth; depth += 1) {
+        if(max_engine_timeout(engine)) {
             return;
         }
 
-        switch(max_engine_search_moves(engine, &scored_moves, search, depth)) {
-            case MAX_ENGINE_STOP_GAMEOVER: {
-                search->gameover = true;
-                return;
-            } break;
+        engine->seldepth = 0;
 
-            case MAX_ENGINE_STOP_TIMECONTROL: {
-                return;
-            } break;
+        for(uint8_t line = 0; line < multipv; ++line) {
+            switch(max_engine_search_line(engine, &scored_moves, search, line, depth, depth > start_depth)) {
+                case MAX_ENGINE_STOP_GAMEOVER: {
+                    search->gameover = true;
+                    return;
+                } break;
 
-            case MAX_ENGINE_STOP_SEARCH_DONE: break;
+                case MAX_ENGINE_STOP_TIMECONTROL: {
+                    return;
+                } break;
+
+                case MAX_ENGINE_STOP_SEARCH_DONE: break;
+            }
         }
 
-        if(depth == 7) {
+        max_engine_sort_lines(search, multipv);
+        search->depth = depth;
+        search->lines_len = multipv;
+        max_engine_word_store(&engine->progress.depth, depth);
+        max_engine_info_iteration(engine, search);
+
+        //A forced mate found at this depth cannot be shortened by searching deeper, though further lines may still
+        //be improved
+        if(multipv == 1 && search->score >= MAX_SCORE_MATE) {
             break;
         }
     }
 }
 
+void max_engine_search(max_engine_t *engine, max_search_limits_t const *limits, max_search_result_t *search) {
+    max_engine_flag_store(&engine->stop_signal, false);
+    max_engine_word_store(&engine->stop_time, 0);
+    max_engine_search_run(engine, limits, search);
+}
+
+void max_engine_search_run(max_engine_t *engine, max_search_limits_t const *limits, max_search_result_t *search) {
+    DIAGNOSTIC(
+        engine->diagnostic = (max_engine_diagnostic_t){
+            .nodes = 0,
+            .ttbl_hits = 0,
+            .ttbl_used = 0,
+            .ttbl_cutoffs = 0,
+            .evalcache_probes = 0,
+            .evalcache_hits = 0,
+        }
+    );
+
+    search->score = MAX_SCORE_LOWEST;
+    search->best = max_smove_none();
+    search->depth = 0;
+    search->gameover = false;
+    search->stop_latency = 0;
+    search->lines_len = 0;
+    engine->nodes = 0;
+    max_engine_word_store(&engine->progress.depth, 0);
+    max_engine_word_store(&engine->progress.nodes, 0);
+    engine->root_ply = engine->board.ply;
+    engine->null_min_ply = 0;
+    engine->extensions = 0;
+    max_ttbl_new_generation(&engine->table);
+    max_engine_heuristics_new_search(&engine->heuristics);
+    max_state_stack_lower_head(&engine->board.stack, 3);
+
+    uint64_t start = max_engine_clock_ms();
+    engine->info.start = start;
+    engine->info.next = start + engine->info.interval;
+    engine->info.last = (max_search_info_t){ .score = MAX_SCORE_LOWEST, .multipv = 1, .pv_len = 0 };
+    uint64_t budget = max_engine_time_budget(limits, max_board_side(&engine->board));
+    max_engine_word_store(&engine->limits.deadline, (budget == UINT64_MAX) ? UINT64_MAX : start + budget);
+    engine->limits.nodes = (limits->nodes == 0) ? UINT64_MAX : limits->nodes;
+    engine->limits.depth = (limits->depth == 0 || limits->depth > MAX_ENGINE_MAX_DEPTH) ? MAX_ENGINE_MAX_DEPTH : limits->depth;
+    engine->limits.poll = 0;
+    engine->limits.stopped = false;
+
+    engine->stop = &engine->stop_signal;
 
-void max_engine_sortmoves(max_engine_t *engine, max_movelist_t moves) {
-    static max_scorelist_t SCORES;
-    max_scorelist_reset(&SCORES, moves);
-    if(moves.len > MAX_ENGINE_MAX_MOVES_PER_PLY) {
-        moves.len = MAX_ENGINE_MAX_MOVES_PER_PLY;
+    #ifdef MAX_THREADS
+    engine->threads.running = max_engine_helpers_start(engine);
+    #endif
+
+    max_engine_iterate(engine, search, 1);
+    search->nodes = engine->nodes;
+
+    #ifdef MAX_THREADS
+    //A ponder search must not finish before the opponent has moved, even if there is nothing left to search
+    while(max_engine_flag_load(&engine->ponder) && !max_engine_flag_load(engine->stop)) {
+        thrd_sleep(&(struct timespec){ .tv_nsec = 1000000 }, NULL);
     }
+    #endif
+
+    #ifdef MAX_THREADS
+    max_engine_helpers_join(engine, engine->threads.running, search);
+    engine->threads.running = 0;
+    #endif
     
-    max_0x88_t best_from = max_0x88_raw(MAX_0x88_INVALID_MASK);
-    max_0x88_t best_to   = max_0x88_raw(MAX_0x88_INVALID_MASK);
-    max_ttentry_t const *probed = max_ttbl_probe_read(&engine->table, max_board_state(&engine->board)->position);
-    if(probed != NULL) {
-        best_from.v = max_ttentry_pattr_source(probed->attr).v;
-        best_to.v   = max_ttentry_pattr_dest(probed->attr).v;
+    uint64_t elapsed = max_engine_clock_ms() - start;
+    search->nps = (elapsed == 0) ? search->nodes * 1000 : (search->nodes * 1000) / elapsed;
+
+    uint64_t stopped = max_engine_word_load(&engine->stop_time);
+    if(stopped != 0) {
+        search->stop_latency = max_engine_clock_us() - stopped;
     }
+}
 
-    for(uint8_t i = 0; i < moves.len; ++i) {
-        max_smove_t move = moves.buf[i];
-        max_score_t score = 0;
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "private/test.h"
 
-        // Most Valuable Viction - Least Valuable Aggressor scoring
-        if(move.tag & MAX_MOVETAG_CAPTURE) {
-            max_score_t aggressor = max_engine_score_piece(engine, engine->board.pieces[move.from.v]);
-            max_score_t victim    = max_engine_score_piece(engine, engine->board.pieces[move.to.v]);
-            score += victim - aggressor;
-        }
-        
-        if(move.from.v == best_from.v && move.to.v == best_to.v) {
-            score += 1000;
-        }
+max_engine_t *max_engine_test_new(void) {
+    static max_engine_t engine;
+    static max_state_t stack[MAX_ENGINE_TEST_STACK_CAP];
+    static max_ttbucket_t table[1];
+    static max_smove_t buf[MAX_ENGINE_TEST_MOVES_CAP];
+
+    max_engine_init_params_t init = (max_engine_init_params_t){
+        .board = { .stack = stack, .capacity = MAX_ENGINE_TEST_STACK_CAP },
+        .ttbl = { .buf = table, .nbit = 0 },
+        .moves = { .buf = buf, .capacity = MAX_ENGINE_TEST_MOVES_CAP },
+    };
+
+    max_engine_new(&engine, &init, max_eval_params_default());
+    return &engine;
+}
 
-        max_scorelist_score(&SCORES, i, score);
+void max_engine_search_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+
+    static char const *FENS[] = {
+        "7k/6Q1/6K1/8/8/8/8/8 b - - 0 1",
+        "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",
+    };
+
+    for(uint8_t multipv = 1; multipv <= 3; multipv += 2) {
+        max_engine_set_multipv(engine, multipv);
+        for(unsigned i = 0; i < sizeof(FENS) / sizeof(FENS[0]); ++i) {
+            ASSERT(max_board_parse_from_fen(&engine->board, FENS[i]) == MAX_FEN_SUCCESS, "Failed to parse %s", FENS[i]);
+
+            max_search_result_t result;
+            max_engine_search(engine, &(max_search_limits_t){ .depth = 4 }, &result);
+            ASSERT(
+                result.gameover && result.lines_len == 0 && max_smove_is_none(result.best),
+                "Search of %s with %u lines does not report the end of the game",
+                FENS[i],
+                multipv
+            );
+        }
     }
 
-    max_scorelist_sort(&SCORES);
+    max_engine_set_multipv(engine, 1);
 }
+
+#endif
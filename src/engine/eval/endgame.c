@@ -0,0 +1,262 @@
+#include "max/engine/eval/endgame.h"
+#include "max/board/loc.h"
+#include "max/board/piecelist.h"
+#include "max/engine/engine.h"
+#include "private/board/board.h"
+#include "private/engine/eval/endgame.h"
+#include <stddef.h>
+
+/// Get the number of king moves between two squares
+static uint8_t max_endgame_distance(max_0x88_t a, max_0x88_t b) {
+    int8_t files = (int8_t)max_0x88_file(a) - (int8_t)max_0x88_file(b);
+    int8_t ranks = (int8_t)max_0x88_rank(a) - (int8_t)max_0x88_rank(b);
+    files = (files < 0) ? -files : files;
+    ranks = (ranks < 0) ? -ranks : ranks;
+    return (files > ranks) ? files : ranks;
+}
+
+/// Get the sum of file and rank distances between two squares
+static uint8_t max_endgame_manhattan(max_0x88_t a, max_0x88_t b) {
+    int8_t files = (int8_t)max_0x88_file(a) - (int8_t)max_0x88_file(b);
+    int8_t ranks = (int8_t)max_0x88_rank(a) - (int8_t)max_0x88_rank(b);
+    return ((files < 0) ? -files : files) + ((ranks < 0) ? -ranks : ranks);
+}
+
+/// Get the sum of file and rank distances from the given square to the four center squares, zero in the center and
+/// six in a corner
+static uint8_t max_endgame_center_distance(max_0x88_t sq) {
+    uint8_t file = max_0x88_file(sq);
+    uint8_t rank = max_0x88_rank(sq);
+    return ((file < 4) ? 3 - file : file - 4) + ((rank < 4) ? 3 - rank : rank - 4);
+}
+
+/// Score a king and a major piece against a bare king by driving the weak king to the edge with the strong king close
+/// behind it, which is all that is needed to find the mate
+static max_score_t max_endgame_krk(max_board_t *board, max_side_t strong) {
+    max_0x88_t king = board->lists[strong].king.loc[0];
+    max_0x88_t weak = board->lists[max_side_enemy(strong)].king.loc[0];
+
+    return MAX_ENDGAME_KNOWN_WIN +
+        30 * max_endgame_center_distance(weak) +
+        10 * (14 - max_endgame_manhattan(king, weak));
+}
+
+/// Score a king, bishop, and knight against a bare king by driving the weak king into a corner of the bishop's color,
+/// the only corners in which mate can be forced
+static max_score_t max_endgame_kbnk(max_board_t *board, max_side_t strong) {
+    max_0x88_t king = board->lists[strong].king.loc[0];
+    max_0x88_t weak = board->lists[max_side_enemy(strong)].king.loc[0];
+    max_0x88_t bishop = board->lists[strong].bishop.loc[0];
+
+    //A1 and H8 are dark squares, as are all squares with an even sum of file and rank
+    bool dark = ((max_0x88_file(bishop) + max_0x88_rank(bishop)) & 1) == 0;
+    max_0x88_t first = dark ? max_0x88_new(0, 0) : max_0x88_new(7, 0);
+    max_0x88_t second = dark ? max_0x88_new(7, 7) : max_0x88_new(0, 7);
+    uint8_t corner = max_endgame_manhattan(weak, first);
+    if(max_endgame_manhattan(weak, second) < corner) {
+        corner = max_endgame_manhattan(weak, second);
+    }
+
+    return MAX_ENDGAME_KNOWN_WIN +
+        40 * (14 - corner) +
+        10 * max_endgame_center_distance(weak) +
+        10 * (14 - max_endgame_manhattan(king, weak));
+}
+
+/// Score a king and pawn against a bare king.
+/// Pawns that outrun the weak king are won, rook pawns are drawn once the weak king reaches the corner in front of
+/// them, and a weak king standing in front of the pawn usually holds the draw.
+static max_score_t max_endgame_kpk(max_board_t *board, max_side_t strong) {
+    max_side_t enemy = max_side_enemy(strong);
+    max_0x88_t king = board->lists[strong].king.loc[0];
+    max_0x88_t weak = board->lists[enemy].king.loc[0];
+    max_0x88_t pawn = board->lists[strong].pawn.loc[0];
+
+    uint8_t file = max_0x88_file(pawn);
+    uint8_t rank = (strong == MAX_SIDE_WHITE) ? max_0x88_rank(pawn) : 7 - max_0x88_rank(pawn);
+    max_0x88_t promote = max_0x88_new((strong == MAX_SIDE_WHITE) ? 7 : 0, file);
+
+    //Rule of the square: a pawn on its starting rank may advance two squares on its first move
+    uint8_t steps = (rank == 1) ? 5 : 7 - rank;
+    int8_t defense = (int8_t)max_endgame_distance(weak, promote) - (max_board_side(board) == enemy);
+    bool blocked = max_0x88_file(king) == file &&
+        ((strong == MAX_SIDE_WHITE) ? max_0x88_rank(king) > max_0x88_rank(pawn) : max_0x88_rank(king) < max_0x88_rank(pawn));
+
+    if(defense > (int8_t)steps && !blocked) {
+        return MAX_ENDGAME_KNOWN_WIN / 2 + 20 * rank;
+    }
+
+    if((file == 0 || file == 7) && max_endgame_distance(weak, promote) <= 1) {
+        return 0;
+    }
+
+    bool ahead = (strong == MAX_SIDE_WHITE) ? max_0x88_rank(weak) > max_0x88_rank(pawn) : max_0x88_rank(weak) < max_0x88_rank(pawn);
+    if(max_0x88_file(weak) == file && ahead) {
+        return 10;
+    }
+
+    return 100 + 20 * rank + 10 * ((int8_t)max_endgame_distance(weak, pawn) - (int8_t)max_endgame_distance(king, pawn));
+}
+
+/// Score a position in which neither side has enough material to deliver mate
+static max_score_t max_endgame_draw(max_board_t *board, max_side_t strong) {
+    (void)board;
+    (void)strong;
+    return 0;
+}
+
+/// Halve the evaluation of endgames with bishops on opposite colors and no other pieces, which are often drawn even
+/// when one side has extra pawns
+static uint8_t max_endgame_scale_bishops(max_board_t *board) {
+    max_0x88_t white = board->side.white.bishop.loc[0];
+    max_0x88_t black = board->side.black.bishop.loc[0];
+    uint8_t wcolor = (max_0x88_file(white) + max_0x88_rank(white)) & 1;
+    uint8_t bcolor = (max_0x88_file(black) + max_0x88_rank(black)) & 1;
+    return (wcolor != bcolor) ? MAX_ENDGAME_SCALE_NORMAL / 2 : MAX_ENDGAME_SCALE_NORMAL;
+}
+
+/// Get the number of pieces of a side other than pawns and the king
+static uint8_t max_endgame_pieces(max_pieces_t const *pieces) {
+    return pieces->knight.len + pieces->bishop.len + pieces->rook.len + pieces->queen.len;
+}
+
+/// Select the specialized evaluator or scale function for the material balance of the board, if any
+static void max_endgame_select(max_materialentry_t *entry, max_board_t *board) {
+    entry->eval = NULL;
+    entry->scale = NULL;
+    entry->strong = MAX_SIDE_WHITE;
+
+    for(max_side_t side = 0; side < MAX_SIDES_LEN; ++side) {
+        max_pieces_t const *strong = &board->lists[side];
+        max_pieces_t const *weak = &board->lists[max_side_enemy(side)];
+        if(weak->pawn.len != 0 || max_endgame_pieces(weak) != 0) {
+            continue;
+        }
+
+        uint8_t pieces = max_endgame_pieces(strong);
+        entry->strong = side;
+
+        if(strong->pawn.len == 0 && pieces == 1 && (strong->rook.len == 1 || strong->queen.len == 1)) {
+            entry->eval = max_endgame_krk;
+        } else if(strong->pawn.len == 0 && pieces == 2 && strong->bishop.len == 1 && strong->knight.len == 1) {
+            entry->eval = max_endgame_kbnk;
+        } else if(strong->pawn.len == 1 && pieces == 0) {
+            entry->eval = max_endgame_kpk;
+        } else if(strong->pawn.len == 0 && pieces <= 1 && strong->rook.len == 0 && strong->queen.len == 0) {
+            entry->eval = max_endgame_draw;
+        } else if(strong->pawn.len == 0 && pieces == 2 && strong->knight.len == 2) {
+            entry->eval = max_endgame_draw;
+        }
+
+        return;
+    }
+
+    max_pieces_t const *white = &board->side.white;
+    max_pieces_t const *black = &board->side.black;
+    if(
+        max_endgame_pieces(white) == 1 && white->bishop.len == 1 &&
+        max_endgame_pieces(black) == 1 && black->bishop.len == 1
+    ) {
+        entry->scale = max_endgame_scale_bishops;
+    }
+}
+
+/// Get the imbalance adjustments of one side's material
+static max_phasescore_t max_endgame_imbalance(max_pieces_t const *pieces, max_engine_imbalance_param_t const *param) {
+    max_phasescore_t score = { .mg = 0, .eg = 0 };
+    if(pieces->bishop.len >= 2) {
+        max_phasescore_add(&score, param->bishop_pair);
+    }
+
+    int16_t pawns = (int16_t)pieces->pawn.len - 5;
+    int16_t adjust = pawns * (pieces->knight.len * param->knight_pawns + pieces->rook.len * param->rook_pawns);
+    max_phasescore_add(&score, (max_phasescore_t){ .mg = adjust, .eg = adjust });
+    return score;
+}
+
+void max_engine_material_eval(max_materialentry_t *entry, max_board_t *board, max_engine_imbalance_param_t const *param) {
+    entry->imbalance = max_endgame_imbalance(&board->side.white, param);
+    max_phasescore_sub(&entry->imbalance, max_endgame_imbalance(&board->side.black, param));
+    max_endgame_select(entry, board);
+}
+
+max_materialentry_t const* max_engine_material_probe(max_engine_t *engine) {
+    max_zobrist_t key = max_board_state(&engine->board)->material;
+    max_materialentry_t *entry = &engine->materials.buf[key & (MAX_ENGINE_MATERIALTBL_LEN - 1)];
+    if(entry->key != key) {
+        max_engine_material_eval(entry, &engine->board, &engine->param.imbalance);
+        entry->key = key;
+    }
+
+    return entry;
+}
+
+void max_engine_material_clear(max_engine_t *engine) {
+    //A zeroed entry has no adjustments and no evaluators, which matches an empty board with a key of zero
+    for(unsigned i = 0; i < MAX_ENGINE_MATERIALTBL_LEN; ++i) {
+        engine->materials.buf[i] = (max_materialentry_t){ .key = 0, .eval = NULL, .scale = NULL };
+    }
+}
+
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "max/board/zobrist.h"
+#include "private/test.h"
+
+void max_engine_endgame_unit_tests(void) {
+    max_state_t buf[4];
+    max_board_t board;
+    max_board_new(&board, buf, MAX_ZOBRIST_DEFAULT_SEED);
+    max_engine_imbalance_param_t param = max_engine_imbalance_param_default();
+    max_materialentry_t entry;
+
+    static const struct {
+        char const *fen;
+        max_endgame_eval_fn eval;
+        max_side_t strong;
+    } CASES[] = {
+        { "8/8/8/4k3/8/8/8/R3K3 w - - 0 1", max_endgame_krk, MAX_SIDE_WHITE },
+        { "8/8/8/4k3/8/2bn4/8/4K3 w - - 0 1", max_endgame_kbnk, MAX_SIDE_BLACK },
+        { "8/8/8/4k3/8/8/4P3/4K3 w - - 0 1", max_endgame_kpk, MAX_SIDE_WHITE },
+        { "8/8/8/4k3/8/8/4N3/4K3 w - - 0 1", max_endgame_draw, MAX_SIDE_WHITE },
+        { "8/8/8/4k3/8/8/3PN3/4K3 w - - 0 1", NULL, MAX_SIDE_WHITE },
+    };
+
+    for(unsigned i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i) {
+        ASSERT(max_board_parse_from_fen(&board, CASES[i].fen) == MAX_FEN_SUCCESS, "Failed to parse %s", CASES[i].fen);
+        max_engine_material_eval(&entry, &board, &param);
+        ASSERT(
+            entry.eval == CASES[i].eval && (entry.eval == NULL || entry.strong == CASES[i].strong),
+            "Wrong endgame evaluator selected for %s",
+            CASES[i].fen
+        );
+    }
+
+    //The weak king is closer to the corner of the bishop's color in the first position
+    ASSERT(max_board_parse_from_fen(&board, "7k/8/5K2/8/8/8/3B4/4N3 w - - 0 1") == MAX_FEN_SUCCESS, "");
+    max_score_t corner = max_endgame_kbnk(&board, MAX_SIDE_WHITE);
+    ASSERT(max_board_parse_from_fen(&board, "k7/8/2K5/8/8/8/3B4/4N3 w - - 0 1") == MAX_FEN_SUCCESS, "");
+    ASSERT(max_endgame_kbnk(&board, MAX_SIDE_WHITE) < corner, "KBNK does not prefer the corner of the bishop's color");
+
+    //A pawn that outruns the weak king is winning, while a weak king in front of the pawn holds
+    ASSERT(max_board_parse_from_fen(&board, "8/8/8/P7/8/8/7k/K7 w - - 0 1") == MAX_FEN_SUCCESS, "");
+    ASSERT(max_endgame_kpk(&board, MAX_SIDE_WHITE) >= MAX_ENDGAME_KNOWN_WIN / 2, "Unstoppable pawn is not winning");
+    ASSERT(max_board_parse_from_fen(&board, "8/8/4k3/8/4P3/4K3/8/8 w - - 0 1") == MAX_FEN_SUCCESS, "");
+    ASSERT(max_endgame_kpk(&board, MAX_SIDE_WHITE) < 100, "Pawn blocked by the weak king is scored above a pawn");
+
+    //A weak king already on the promotion square holds the draw when it is to move
+    ASSERT(max_board_parse_from_fen(&board, "4k3/8/8/8/8/8/4P3/4K3 b - - 0 1") == MAX_FEN_SUCCESS, "");
+    ASSERT(max_endgame_kpk(&board, MAX_SIDE_WHITE) < 100, "Weak king on the promotion square does not hold the pawn");
+    ASSERT(max_board_parse_from_fen(&board, "k7/8/8/8/8/8/P7/K7 b - - 0 1") == MAX_FEN_SUCCESS, "");
+    ASSERT(max_endgame_kpk(&board, MAX_SIDE_WHITE) == 0, "Weak king in the corner of a rook pawn is not a draw");
+
+    ASSERT(max_board_parse_from_fen(&board, "8/4k3/3b1p2/8/8/2PB4/4K3/8 w - - 0 1") == MAX_FEN_SUCCESS, "");
+    max_engine_material_eval(&entry, &board, &param);
+    ASSERT(entry.scale == max_endgame_scale_bishops, "Bishop endgame does not select the bishop scale function");
+    ASSERT(
+        entry.scale(&board) == MAX_ENDGAME_SCALE_NORMAL / 2,
+        "Bishops on opposite colors do not halve the evaluation"
+    );
+}
+
+#endif
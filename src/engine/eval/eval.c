@@ -5,7 +5,9 @@
 #include "private/board/board.h"
 #include "private/engine/engine.h"
 #include "private/engine/eval.h"
+#include "private/engine/eval/endgame.h"
 #include "private/engine/eval/strategy.h"
+#include <stddef.h>
 
 static max_score_t MAX_SCOREMUL[MAX_SIDES_LEN] = {
     [MAX_SIDE_WHITE] = 1,
@@ -29,46 +31,217 @@ static max_score_t max_count_squares(max_engine_t *engine, max_0x88_t pos, max_0
     }
 }
 
-static max_score_t max_engine_score_piecelist(max_engine_t *engine, max_side_t side) {
+static max_score_t max_engine_score_piecelist(max_engine_t *engine, max_pawnentry_t const *pawns, max_side_t side) {
     max_score_t score = 0;
 
     const max_pieces_t *pieces = max_board_side_list(&engine->board, side);
     for(unsigned i = 0; i < pieces->knight.len; ++i) {
-        score += max_engine_outpost(engine->param.strategy.outpost, &engine->board, pieces->knight.loc[i], side);
+        score += max_engine_outpost(engine->param.strategy.outpost, pawns, pieces->knight.loc[i], side);
     }
 
     for(unsigned i = 0; i < pieces->rook.len; ++i) {
-        score += max_engine_outpost(engine->param.strategy.outpost, &engine->board, pieces->rook.loc[i], side);
+        score += max_engine_outpost(engine->param.strategy.outpost, pawns, pieces->rook.loc[i], side);
     }
 
     return score;
 }
 
+void max_engine_psqt_build(max_psqt_t *psqt, max_eval_params_t const *param) {
+    for(max_side_t side = 0; side < MAX_SIDES_LEN; ++side) {
+        for(unsigned kind = 0; kind < MAX_PIECEINDEX_LEN; ++kind) {
+            max_score_t material = param->material.array[kind];
+
+            for(unsigned i = 0; i < MAX_6BIT_LEN; ++i) {
+                max_6bit_t idx = max_pstbl_index(max_6bit_to_0x88(max_6bit_raw(i)), side);
+                psqt->score[side][kind][i] = (max_phasescore_t){
+                    .mg = (material + param->position.mg.array[kind][idx.v]) * MAX_SCOREMUL[side],
+                    .eg = (material + param->position.eg.array[kind][idx.v]) * MAX_SCOREMUL[side],
+                };
+            }
+        }
+    }
+
+    max_engine_phase_cfg_t const *phase = &param->position.phase;
+    for(unsigned kind = 0; kind < MAX_PIECEINDEX_LEN; ++kind) {
+        psqt->phase[kind] = phase->array[kind];
+    }
+
+    //Guard against dividing by zero when tapering if every phase weight is zero
+    uint8_t max = 16 * phase->pawn + 4 * phase->knight + 4 * phase->bishop + 4 * phase->rook + 2 * phase->queen;
+    psqt->phase_max = (max == 0) ? 1 : max;
+}
+
+void max_engine_evalcache_clear(max_engine_t *engine) {
+    //A zeroed entry is only ever hit by a position with a key of zero, which is as unlikely as any other collision
+    for(unsigned i = 0; i < MAX_ENGINE_EVALCACHE_LEN; ++i) {
+        engine->evals.buf[i] = (max_evalentry_t){ .key = 0, .score = 0 };
+    }
+}
+
 max_score_t max_engine_eval(max_engine_t *engine) {
+    DIAGNOSTIC(engine->diagnostic.nodes += 1);
+
+    max_zobrist_t key = max_board_state(&engine->board)->position;
+    max_evalentry_t *cached = &engine->evals.buf[key & (MAX_ENGINE_EVALCACHE_LEN - 1)];
+    DIAGNOSTIC(engine->diagnostic.evalcache_probes += 1);
+    if(cached->key == key) {
+        DIAGNOSTIC(engine->diagnostic.evalcache_hits += 1);
+        return cached->score;
+    }
+
     max_score_t score = 0;
+    max_materialentry_t const *material = max_engine_material_probe(engine);
+
+    if(material->eval != NULL) {
+        //Specialized endgame evaluators replace the general evaluation entirely
+        score = material->eval(&engine->board, material->strong) * MAX_SCOREMUL[material->strong];
+    } else {
+        max_pawnentry_t const *pawns = max_engine_pawns_probe(engine);
+
+        score +=
+            max_engine_score_piecelist(engine, pawns, MAX_SIDE_WHITE) -
+            max_engine_score_piecelist(engine, pawns, MAX_SIDE_BLACK);
+        
+        //Material and piece-square scores are accumulated by the board as pieces are moved, and share the tapering
+        //of the cached pawn structure and material imbalance scores
+        max_phasescore_t tapered = engine->board.score;
+        max_phasescore_add(&tapered, pawns->score);
+        max_phasescore_add(&tapered, material->imbalance);
+        score += max_engine_taper(&engine->psqt, tapered, engine->board.phase);
+
+        if(material->scale != NULL) {
+            score = (max_score_t)((int32_t)score * material->scale(&engine->board) / MAX_ENDGAME_SCALE_NORMAL);
+        }
+    }
 
-    score +=
-        max_engine_score_piecelist(engine, MAX_SIDE_WHITE) -
-        max_engine_score_piecelist(engine, MAX_SIDE_BLACK);
-    
-    score +=
-        max_engine_score_material(&engine->param.material, &engine->board.side.white) - 
+    score *= MAX_SCOREMUL[max_board_side(&engine->board)];
+    *cached = (max_evalentry_t){ .key = key, .score = score };
+    return score;
+}
+
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "max/board/movegen.h"
+#include "max/board/squares.h"
+#include "private/test.h"
+
+/// Compute the material and piece-square score of the engine's board by iterating all piece lists
+static max_phasescore_t max_engine_psqt_rescan(max_engine_t *engine) {
+    max_score_t material =
+        max_engine_score_material(&engine->param.material, &engine->board.side.white) -
         max_engine_score_material(&engine->param.material, &engine->board.side.black);
 
-    score +=
-        max_engine_score_positions(engine, &engine->board.side.white, MAX_SIDE_WHITE) -
-        max_engine_score_positions(engine, &engine->board.side.black, MAX_SIDE_BLACK);
+    return (max_phasescore_t){
+        .mg = material +
+            max_engine_score_positions(&engine->param.position.mg, &engine->board.side.white, MAX_SIDE_WHITE) -
+            max_engine_score_positions(&engine->param.position.mg, &engine->board.side.black, MAX_SIDE_BLACK),
+        .eg = material +
+            max_engine_score_positions(&engine->param.position.eg, &engine->board.side.white, MAX_SIDE_WHITE) -
+            max_engine_score_positions(&engine->param.position.eg, &engine->board.side.black, MAX_SIDE_BLACK),
+    };
+}
 
-    DIAGNOSTIC(engine->diagnostic.nodes += 1);
+/// Compute the game phase of the engine's board by counting the pieces of both sides
+static uint8_t max_engine_phase_rescan(max_engine_t *engine) {
+    max_engine_phase_cfg_t const *phase = &engine->param.position.phase;
+    uint8_t sum = 0;
+    for(max_side_t side = 0; side < MAX_SIDES_LEN; ++side) {
+        max_pieces_t *pieces = max_board_side_list(&engine->board, side);
+        sum +=
+            pieces->pawn.len * phase->pawn +
+            pieces->knight.len * phase->knight +
+            pieces->bishop.len * phase->bishop +
+            pieces->rook.len * phase->rook +
+            pieces->queen.len * phase->queen;
+    }
 
-    return score * MAX_SCOREMUL[max_board_side(&engine->board)];
+    return sum;
 }
 
-#ifdef MAX_TESTS
+/// Check if the accumulated score and phase of the engine's board match a full rescan of its piece lists
+static bool max_engine_psqt_matches(max_engine_t *engine) {
+    max_phasescore_t expected = max_engine_psqt_rescan(engine);
+    return
+        engine->board.score.mg == expected.mg &&
+        engine->board.score.eg == expected.eg &&
+        engine->board.phase == max_engine_phase_rescan(engine);
+}
+
+/// Ensure that the scores accumulated by the board match a full rescan after making and unmaking every move
+static void max_engine_psqt_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+
+    static char const *FENS[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    };
+
+    for(unsigned i = 0; i < sizeof(FENS) / sizeof(FENS[0]); ++i) {
+        ASSERT(max_board_parse_from_fen(&engine->board, FENS[i]) == MAX_FEN_SUCCESS, "Failed to parse %s", FENS[i]);
+        max_phasescore_t before = engine->board.score;
+        uint8_t phase = engine->board.phase;
+
+        max_movelist_t moves = max_movelist_slice(&engine->moves);
+        max_board_movegen_legal(&engine->board, &moves);
+
+        unsigned mismatched = 0;
+        for(unsigned j = 0; j < moves.len; ++j) {
+            max_board_make_move(&engine->board, moves.buf[j]);
+            mismatched += !max_engine_psqt_matches(engine);
+            max_board_unmake_move(&engine->board, moves.buf[j]);
+            mismatched += engine->board.score.mg != before.mg || engine->board.score.eg != before.eg;
+            mismatched += engine->board.phase != phase;
+        }
+
+        ASSERT(max_engine_psqt_matches(engine), "Accumulated score of %s differs from a rescan", FENS[i]);
+        ASSERT(mismatched == 0, "Accumulated score of %s diverges %u times over make and unmake", FENS[i], mismatched);
+    }
+}
+
+/// Ensure that the tapered score is the midgame score at the starting phase and the endgame score without pieces
+static void max_engine_taper_unit_tests(void) {
+    max_psqt_t psqt = { .phase_max = 24 };
+    max_phasescore_t score = { .mg = 100, .eg = -50 };
+
+    ASSERT(max_engine_taper(&psqt, score, 24) == 100, "Starting phase does not give the midgame score");
+    ASSERT(max_engine_taper(&psqt, score, 40) == 100, "Promotions do not clamp the phase to the midgame score");
+    ASSERT(max_engine_taper(&psqt, score, 0) == -50, "Bare kings and pawns do not give the endgame score");
+    ASSERT(max_engine_taper(&psqt, score, 12) == 25, "Half of the starting phase does not average both scores");
+}
+
+/// Ensure that cached evaluations match evaluating the position again from scratch
+static void max_engine_evalcache_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+    ASSERT(
+        max_board_parse_from_fen(&engine->board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1") == MAX_FEN_SUCCESS,
+        "FEN parse when setting up evaluation cache unit test fails"
+    );
+
+    max_zobrist_t key = max_board_state(&engine->board)->position;
+    max_score_t fresh = max_engine_eval(engine);
+    max_evalentry_t const *cached = &engine->evals.buf[key & (MAX_ENGINE_EVALCACHE_LEN - 1)];
+    ASSERT(cached->key == key && cached->score == fresh, "Evaluation of the position was not stored in the cache");
+
+    //The cached score must also be returned after the board has moved away from and back to the position
+    max_board_make_move(&engine->board, max_smove_normal(MAX_E5, MAX_G4));
+    max_score_t child = max_engine_eval(engine);
+    max_board_unmake_move(&engine->board, max_smove_normal(MAX_E5, MAX_G4));
+    ASSERT(max_engine_eval(engine) == fresh, "Cached evaluation differs from the fresh evaluation");
+
+    max_engine_evalcache_clear(engine);
+    max_board_make_move(&engine->board, max_smove_normal(MAX_E5, MAX_G4));
+    ASSERT(max_engine_eval(engine) == child, "Cached evaluation of a child differs from the fresh evaluation");
+    max_board_unmake_move(&engine->board, max_smove_normal(MAX_E5, MAX_G4));
+}
 
 /// Ensure that basic position heuristics are properly functioning
 void max_engine_eval_tests(void) {
     max_engine_strategic_eval_tests();
+    max_engine_psqt_unit_tests();
+    max_engine_taper_unit_tests();
+    max_engine_evalcache_unit_tests();
+    max_engine_endgame_unit_tests();
 }
 
 #endif
@@ -1,80 +1,167 @@
 #include "max/engine/eval/strategy.h"
-#include "max/board/dir.h"
-#include "max/board/movegen/pawn.h"
 #include "max/board/piececode.h"
 #include "max/board/zobrist.h"
+#include "max/engine/engine.h"
+#include "private/board/board.h"
+#include "private/engine/eval/strategy.h"
 
+/// Get a mask of the ranks in front of the given rank, as seen from the given side
+MAX_INLINE_ALWAYS uint8_t max_engine_ranks_ahead(uint8_t rank, max_side_t side) {
+    return (side == MAX_SIDE_WHITE) ? (uint8_t)(0xFF << (rank + 1)) : (uint8_t)((1 << rank) - 1);
+}
 
-max_score_t max_engine_pawn_attacks_span(const max_board_t *board, max_0x88_t sq, max_side_t enemy) {
-    const max_0x88_dir_t advance = MAX_PAWN_ADVANCE_DIR[enemy];
-    const max_piececode_t enemy_pawn = max_piececode_new(enemy, MAX_PIECECODE_PAWN);
-    
-    max_score_t count = 0;
+/// Get a rank mask of the files to either side of the given file in a per-file table of rank masks
+MAX_INLINE_ALWAYS uint8_t max_engine_adjacent_files(uint8_t const files[8], uint8_t file) {
+    return ((file > 0) ? files[file - 1] : 0) | ((file < 7) ? files[file + 1] : 0);
+}
 
-    for(;;) {
-        sq = max_0x88_move(sq, advance);
-        if(!max_0x88_valid(sq)) {
-            break;
-        }
+void max_engine_pawns_eval(max_pawnentry_t *entry, max_board_t *board, max_engine_strat_param_t const *param) {
+    //Rank masks of the pawns on each file, and of the squares attacked by pawns on each file
+    uint8_t files[MAX_SIDES_LEN][8] = {0};
+    uint8_t attacks[MAX_SIDES_LEN][8] = {0};
 
-        //No need to do validity checking for the moved square because returned piececode will always be MAX_PIECECODE_INVALID
-        //if the moved position is now off the board
-        if(board->pieces[max_0x88_move(sq, MAX_0x88_DIR_LEFT).v].v == enemy_pawn.v) {
-            count += 1;
-        }
-        if(board->pieces[max_0x88_move(sq, MAX_0x88_DIR_RIGHT).v].v == enemy_pawn.v) {
-            count += 1;
+    for(max_side_t side = 0; side < MAX_SIDES_LEN; ++side) {
+        entry->passed[side] = 0;
+        entry->outposts[side] = 0;
+        for(uint8_t file = 0; file < 8; ++file) {
+            entry->spans[side][file] = 0;
         }
 
-        sq = max_0x88_move(sq, advance);
+        max_pieces_t *pieces = max_board_side_list(board, side);
+        for(unsigned i = 0; i < pieces->pawn.len; ++i) {
+            uint8_t file = max_0x88_file(pieces->pawn.loc[i]);
+            uint8_t rank = max_0x88_rank(pieces->pawn.loc[i]);
+            uint8_t ahead = max_engine_ranks_ahead(rank, side);
+            uint8_t front = (side == MAX_SIDE_WHITE) ? (uint8_t)(1 << (rank + 1)) : (uint8_t)(1 << (rank - 1));
+
+            files[side][file] |= 1 << rank;
+            if(file > 0) {
+                attacks[side][file - 1] |= front;
+                entry->spans[side][file - 1] |= ahead;
+            }
+
+            if(file < 7) {
+                attacks[side][file + 1] |= front;
+                entry->spans[side][file + 1] |= ahead;
+            }
+        }
     }
 
-    return count;
-}
+    entry->score = (max_phasescore_t){ .mg = 0, .eg = 0 };
+    for(max_side_t side = 0; side < MAX_SIDES_LEN; ++side) {
+        max_side_t enemy = max_side_enemy(side);
+        max_phasescore_t score = { .mg = 0, .eg = 0 };
+
+        max_pieces_t *pieces = max_board_side_list(board, side);
+        for(unsigned i = 0; i < pieces->pawn.len; ++i) {
+            uint8_t file = max_0x88_file(pieces->pawn.loc[i]);
+            uint8_t rank = max_0x88_rank(pieces->pawn.loc[i]);
+            uint8_t ahead = max_engine_ranks_ahead(rank, side);
+            uint8_t neighbors = max_engine_adjacent_files(files[side], file);
+
+            if(((files[enemy][file] | max_engine_adjacent_files(files[enemy], file)) & ahead) == 0) {
+                entry->passed[side] |= 1 << file;
+                max_phasescore_add(&score, param->passed[(side == MAX_SIDE_WHITE) ? rank : 7 - rank]);
+            }
+
+            if(files[side][file] & ahead) {
+                max_phasescore_add(&score, param->doubled);
+            }
+
+            if(neighbors == 0) {
+                max_phasescore_add(&score, param->isolated);
+            } else if((neighbors & ~ahead) == 0) {
+                //Every pawn on an adjacent file has advanced past this one, so it is backward if enemy pawns guard
+                //the square in front of it
+                uint8_t stop = (side == MAX_SIDE_WHITE) ? (uint8_t)(1 << (rank + 1)) : (uint8_t)(1 << (rank - 1));
+                if(attacks[enemy][file] & stop) {
+                    max_phasescore_add(&score, param->backward);
+                }
+            }
+        }
 
-#include <stdio.h>
+        //Outposts are on the fourth to seventh ranks as seen from the side occupying them
+        for(uint8_t file = 0; file < 8; ++file) {
+            uint8_t outposts = attacks[side][file] & ~entry->spans[enemy][file];
+            outposts &= (side == MAX_SIDE_WHITE) ? 0x78 : 0x1E;
 
-max_score_t max_engine_outpost(max_score_t outpost_bonus, const max_board_t *board, max_0x88_t sq, max_side_t side) {
-    const max_side_t enemy = max_side_enemy(side);
-    uint8_t rank = max_0x88_rank(sq);
-    if(rank < 3 || rank > 6) {
-        return 0;
+            for(uint8_t rank = 0; rank < 8; ++rank) {
+                if(outposts & (1 << rank)) {
+                    entry->outposts[side] |= (uint64_t)1 << max_0x88_to_6bit(max_0x88_new(rank, file)).v;
+                }
+            }
+        }
+
+        if(side == MAX_SIDE_WHITE) {
+            max_phasescore_add(&entry->score, score);
+        } else {
+            max_phasescore_sub(&entry->score, score);
+        }
     }
-    
-    const max_piececode_t friendly_pawn = max_piececode_new(side, MAX_PIECECODE_PAWN);
-    const max_0x88_t protector_pawn = max_0x88_move(sq, MAX_PAWN_ADVANCE_DIR[enemy]);
-
-    //No need for bounds checks as invalid indices wil return MAX_PIECECODE_INVALID
-    if(
-        board->pieces[max_0x88_move(protector_pawn, MAX_0x88_DIR_LEFT).v].v != friendly_pawn.v &&
-        board->pieces[max_0x88_move(protector_pawn, MAX_0x88_DIR_RIGHT).v].v != friendly_pawn.v
-    ) {
-        printf("No protector %0x\n", board->pieces[max_0x88_move(protector_pawn, MAX_0x88_DIR_RIGHT).v].v);
-        return 0;
+}
+
+max_pawnentry_t const* max_engine_pawns_probe(max_engine_t *engine) {
+    max_zobrist_t key = max_board_state(&engine->board)->pawns;
+    max_pawnentry_t *entry = &engine->pawns.buf[key & (MAX_ENGINE_PAWNTBL_LEN - 1)];
+    if(entry->key != key) {
+        max_engine_pawns_eval(entry, &engine->board, &engine->param.strategy);
+        entry->key = key;
     }
 
-    return outpost_bonus >> (max_engine_pawn_attacks_span(board, sq, enemy));
+    return entry;
+}
+
+void max_engine_pawns_clear(max_engine_t *engine) {
+    //A table of zeroed entries is valid, as every field of a zeroed entry matches the empty pawn structure that has
+    //a key of zero
+    for(unsigned i = 0; i < MAX_ENGINE_PAWNTBL_LEN; ++i) {
+        engine->pawns.buf[i] = (max_pawnentry_t){0};
+    }
 }
 
 #ifdef MAX_TESTS
 #include "private/test.h"
 #include "max/board/fen.h"
+#include "max/board/squares.h"
 
 void max_engine_strategic_eval_tests(void) {
     static const max_score_t OUTPOST_BONUS = 1000;
     max_state_t buf[10];
     max_board_t board;
     max_board_new(&board, buf, MAX_ZOBRIST_DEFAULT_SEED);
+    max_engine_strat_param_t param = max_engine_strat_param_default();
+    max_pawnentry_t entry;
     
     ASSERT(max_board_parse_from_fen(&board, "8/8/8/pr6/Np6/1P6/8/8 w - -") == MAX_FEN_SUCCESS, "");
+    max_engine_pawns_eval(&entry, &board, &param);
     
     MAX_TEST_ASSERT_WITH(
-        max_engine_outpost(OUTPOST_BONUS, &board, max_0x88_new(3, 0), MAX_SIDE_WHITE) == OUTPOST_BONUS,
+        max_engine_outpost(OUTPOST_BONUS, &entry, MAX_A4, MAX_SIDE_WHITE) == OUTPOST_BONUS,
         {
             printf("A4 not marked as an outpost square\n");
             max_board_print(&board);
         }
     );
+
+    //Every pawn is passed, and the pawns on e5 and c6 protect squares that the enemy's pawns can never attack
+    ASSERT(max_board_parse_from_fen(&board, "4k3/7p/2p4p/4P3/P7/8/8/4K3 w - -") == MAX_FEN_SUCCESS, "");
+    max_engine_pawns_eval(&entry, &board, &param);
+    ASSERT(
+        entry.passed[MAX_SIDE_WHITE] == ((1 << MAX_FILE_A) | (1 << MAX_FILE_E)),
+        "White passed pawn files are %x, expecting the A and E files",
+        entry.passed[MAX_SIDE_WHITE]
+    );
+    ASSERT(
+        entry.passed[MAX_SIDE_BLACK] == ((1 << MAX_FILE_C) | (1 << MAX_FILE_H)),
+        "Black passed pawn files are %x, expecting the C and H files",
+        entry.passed[MAX_SIDE_BLACK]
+    );
+    ASSERT((entry.outposts[MAX_SIDE_WHITE] >> max_0x88_to_6bit(MAX_D6).v) & 1, "D6 is not a white outpost");
+    ASSERT((entry.outposts[MAX_SIDE_BLACK] >> max_0x88_to_6bit(MAX_D5).v) & 1, "D5 is not a black outpost");
+    ASSERT(
+        !((entry.outposts[MAX_SIDE_BLACK] >> max_0x88_to_6bit(MAX_B5).v) & 1),
+        "B5 is marked as a black outpost, but may be attacked by the a4 pawn"
+    );
 }
 
 #endif
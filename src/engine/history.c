@@ -0,0 +1,75 @@
+#include "private/engine/history.h"
+#include <string.h>
+
+void max_engine_heuristics_clear(max_engine_heuristics_t *heuristics) {
+    memset(heuristics->history, 0, sizeof(heuristics->history));
+    for(unsigned i = 0; i < MAX_6BIT_LEN; ++i) {
+        for(unsigned j = 0; j < MAX_6BIT_LEN; ++j) {
+            heuristics->counter[i][j] = max_smove_none();
+        }
+    }
+
+    max_engine_heuristics_new_search(heuristics);
+}
+
+void max_engine_heuristics_new_search(max_engine_heuristics_t *heuristics) {
+    for(unsigned i = 0; i < MAX_ENGINE_MAX_PLY; ++i) {
+        for(unsigned j = 0; j < MAX_ENGINE_KILLERS_LEN; ++j) {
+            heuristics->stack[i].killers[j] = max_smove_none();
+        }
+
+        heuristics->stack[i].move = max_smove_none();
+    }
+
+    for(unsigned side = 0; side < MAX_SIDES_LEN; ++side) {
+        for(unsigned i = 0; i < MAX_6BIT_LEN; ++i) {
+            for(unsigned j = 0; j < MAX_6BIT_LEN; ++j) {
+                heuristics->history[side][i][j] /= 2;
+            }
+        }
+    }
+}
+
+/// Move a history score towards the given bonus, scaled down as the score approaches #MAX_ENGINE_HISTORY_MAX so that
+/// it can never overflow and recent results keep shifting the score of frequently updated moves
+static void max_engine_history_update(max_engine_heuristics_t *heuristics, max_side_t side, max_smove_t move, int32_t bonus) {
+    int16_t *entry = &heuristics->history[side][max_0x88_to_6bit(move.from).v][max_0x88_to_6bit(move.to).v];
+    int32_t magnitude = bonus < 0 ? -bonus : bonus;
+    *entry += bonus - (int32_t)*entry * magnitude / MAX_ENGINE_HISTORY_MAX;
+}
+
+void max_engine_heuristics_cutoff(
+    max_engine_heuristics_t *heuristics,
+    uint8_t ply,
+    max_side_t side,
+    max_smove_t move,
+    max_smove_t const *quiets,
+    uint8_t quiets_len,
+    uint8_t depth
+) {
+    if(ply < MAX_ENGINE_MAX_PLY) {
+        max_smove_t *killers = heuristics->stack[ply].killers;
+        if(!max_smove_eq(killers[0], move)) {
+            for(unsigned i = MAX_ENGINE_KILLERS_LEN - 1; i > 0; --i) {
+                killers[i] = killers[i - 1];
+            }
+
+            killers[0] = move;
+        }
+    }
+
+    if(ply > 0 && ply <= MAX_ENGINE_MAX_PLY) {
+        max_smove_t previous = heuristics->stack[ply - 1].move;
+        heuristics->counter[max_0x88_to_6bit(previous.from).v][max_0x88_to_6bit(previous.to).v] = move;
+    }
+
+    int32_t bonus = (int32_t)depth * depth;
+    if(bonus > MAX_ENGINE_HISTORY_MAX) {
+        bonus = MAX_ENGINE_HISTORY_MAX;
+    }
+
+    max_engine_history_update(heuristics, side, move, bonus);
+    for(uint8_t i = 0; i < quiets_len; ++i) {
+        max_engine_history_update(heuristics, side, quiets[i], -bonus);
+    }
+}
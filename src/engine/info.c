@@ -0,0 +1,78 @@
+#include "max/engine/engine.h"
+#include "max/board/board.h"
+#include "max/engine/tt.h"
+#include "private/engine/search.h"
+#include <stddef.h>
+
+void max_engine_set_info(max_engine_t *engine, max_search_info_fn callback, void *data, uint32_t interval) {
+    engine->info.callback = callback;
+    engine->info.data = data;
+    engine->info.interval = interval;
+}
+
+/// Get the number of nodes searched so far by the main engine and all of its running helper threads
+static uint64_t max_engine_info_nodes(max_engine_t *engine) {
+    uint64_t nodes = engine->nodes;
+
+    #ifdef MAX_THREADS
+    for(uint8_t i = 0; i < engine->threads.running; ++i) {
+        nodes += max_engine_word_load(&engine->threads.buf[i].engine.progress.nodes);
+    }
+    #endif
+
+    return nodes;
+}
+
+/// Fill the node count, speed, elapsed time, and table usage of a report
+static void max_engine_info_counters(max_engine_t *engine, max_search_info_t *info, uint64_t now) {
+    info->seldepth = engine->seldepth;
+    info->nodes = max_engine_info_nodes(engine);
+    info->time = now - engine->info.start;
+    info->nps = (info->time == 0) ? info->nodes * 1000 : (info->nodes * 1000) / info->time;
+    info->hashfull = max_ttbl_hashfull(&engine->table);
+}
+
+void max_engine_info_iteration(max_engine_t *engine, max_search_result_t const *search) {
+    if(engine->info.callback == NULL) {
+        return;
+    }
+
+    uint64_t now = max_engine_clock_ms();
+    max_search_info_t info;
+    info.depth = search->depth;
+    info.complete = true;
+    max_engine_info_counters(engine, &info, now);
+
+    for(uint8_t line = 0; line < search->lines_len; ++line) {
+        info.multipv = line + 1;
+        info.score = search->lines[line].score;
+        info.pv_len = search->lines[line].pv_len;
+        for(uint8_t i = 0; i < info.pv_len; ++i) {
+            info.pv[i] = search->lines[line].pv[i];
+        }
+
+        //Periodic reports only repeat the best line
+        if(line == 0) {
+            engine->info.last = info;
+        }
+
+        engine->info.callback(&info, engine->info.data);
+    }
+
+    engine->info.next = now + engine->info.interval;
+}
+
+void max_engine_info_poll(max_engine_t *engine, uint64_t now) {
+    if(engine->info.callback == NULL || engine->info.interval == 0 || now < engine->info.next) {
+        return;
+    }
+
+    //The board is in the middle of a line, so the last completed iteration's line is repeated instead
+    max_search_info_t info = engine->info.last;
+    info.depth = (uint8_t)max_engine_word_load(&engine->progress.depth) + 1;
+    info.complete = false;
+    max_engine_info_counters(engine, &info, now);
+
+    engine->info.next = now + engine->info.interval;
+    engine->info.callback(&info, engine->info.data);
+}
@@ -0,0 +1,340 @@
+#include "private/engine/picker.h"
+#include "max/board/movegen.h"
+#include "max/board/state.h"
+#include "private/board/board.h"
+#include "private/engine/history.h"
+#include "private/engine/see.h"
+#include <stddef.h>
+
+void max_picker_new(max_picker_t *picker, max_movelist_t moves, max_smove_t hash, max_smove_t const *killers, max_smove_t counter) {
+    picker->moves = moves;
+    picker->hash = hash;
+    for(uint8_t i = 0; i < MAX_PICKER_KILLERS_LEN; ++i) {
+        picker->refutations[i] = (killers != NULL) ? killers[i] : max_smove_none();
+    }
+
+    picker->refutations[MAX_PICKER_KILLERS_LEN] = counter;
+    picker->capture = 0;
+    picker->captures_end = 0;
+    picker->quiet = 0;
+    picker->refutation = 0;
+    picker->stage = MAX_PICKER_STAGE_HASH;
+    picker->evasion = false;
+    picker->tactical = false;
+}
+
+void max_picker_new_tactical(max_picker_t *picker, max_movelist_t moves, max_smove_t hash) {
+    //A quiet hash move is still worth trying first when in check, but the picker cannot know that before generating
+    //moves, so it is left to be yielded in order as an evasion
+    max_picker_new(picker, moves, max_picker_is_tactical(hash) ? hash : max_smove_none(), NULL, max_smove_none());
+    picker->tactical = true;
+}
+
+/// Score a capture or promotion by the material it is expected to win once all recaptures on its destination square
+/// have been played out, so that captures scored below zero lose material.
+static MAX_INLINE_ALWAYS max_score_t max_picker_score_tactical(max_engine_t *engine, max_smove_t move) {
+    return max_engine_see(engine, move);
+}
+
+/// Swap two moves and their scores in the picker's lists
+static MAX_INLINE_ALWAYS void max_picker_swap(max_picker_t *picker, uint16_t a, uint16_t b) {
+    max_smove_t move = picker->moves.buf[a];
+    max_score_t score = picker->scores[a];
+    picker->moves.buf[a] = picker->moves.buf[b];
+    picker->scores[a] = picker->scores[b];
+    picker->moves.buf[b] = move;
+    picker->scores[b] = score;
+}
+
+/// Generate and score only the legal captures and promotions for the node, deferring quiet move generation until
+/// every good capture has been searched.
+static void max_picker_generate_captures(max_picker_t *picker, max_engine_t *engine) {
+    max_board_movegen_captures(&engine->board, &picker->moves);
+    max_board_movegen_retain_legal(&engine->board, &picker->legal, &picker->moves, 0);
+    MAX_ASSERT(picker->moves.len <= MAX_PICKER_CAPACITY);
+
+    for(uint16_t i = 0; i < picker->moves.len; ++i) {
+        picker->scores[i] = max_picker_score_tactical(engine, picker->moves.buf[i]);
+    }
+
+    picker->capture = 0;
+    picker->captures_end = picker->moves.len;
+    picker->quiet = picker->moves.len;
+}
+
+/// Generate all legal quiet moves for the node after the captures and promotions already in the list.
+static void max_picker_generate_quiets(max_picker_t *picker, max_engine_t *engine) {
+    max_board_movegen_quiets(&engine->board, &picker->moves);
+    max_board_movegen_retain_legal(&engine->board, &picker->legal, &picker->moves, picker->captures_end);
+    MAX_ASSERT(picker->moves.len <= MAX_PICKER_CAPACITY);
+
+    max_side_t side = max_board_side(&engine->board);
+    for(uint16_t i = picker->captures_end; i < picker->moves.len; ++i) {
+        picker->scores[i] = max_engine_history_score(&engine->heuristics, side, picker->moves.buf[i]);
+    }
+}
+
+/// Generate every legal check evasion at once, as there are few enough that splitting captures from quiet moves
+/// saves no work, then move the captures and promotions to the front of the list and score them.
+static void max_picker_generate_evasions(max_picker_t *picker, max_engine_t *engine) {
+    max_board_movegen_evasions(&engine->board, &picker->moves, &picker->legal);
+    max_board_movegen_retain_legal(&engine->board, &picker->legal, &picker->moves, 0);
+    MAX_ASSERT(picker->moves.len <= MAX_PICKER_CAPACITY);
+
+    max_side_t side = max_board_side(&engine->board);
+    uint16_t tactical = 0;
+    for(uint16_t i = 0; i < picker->moves.len; ++i) {
+        picker->scores[i] = max_engine_history_score(&engine->heuristics, side, picker->moves.buf[i]);
+        if(max_picker_is_tactical(picker->moves.buf[i])) {
+            picker->scores[i] = max_picker_score_tactical(engine, picker->moves.buf[i]);
+            max_picker_swap(picker, i, tactical);
+            tactical += 1;
+        }
+    }
+
+    picker->capture = 0;
+    picker->captures_end = tactical;
+    picker->quiet = tactical;
+}
+
+/// Move the highest scored move between the given index and the end index to the given index.
+static void max_picker_select(max_picker_t *picker, uint16_t idx, uint16_t end) {
+    uint16_t best = idx;
+    for(uint16_t i = idx + 1; i < end; ++i) {
+        if(picker->scores[i] > picker->scores[best]) {
+            best = i;
+        }
+    }
+
+    max_picker_swap(picker, idx, best);
+}
+
+/// Stable insertion sort of all quiet moves by their scores, highest first.
+/// Quiet moves are usually nearly sorted already, so this is cheaper than selecting the best move every time.
+static void max_picker_sort_quiets(max_picker_t *picker) {
+    for(uint16_t i = picker->captures_end + 1; i < picker->moves.len; ++i) {
+        max_smove_t move = picker->moves.buf[i];
+        max_score_t score = picker->scores[i];
+        uint16_t j = i;
+        while(j > picker->captures_end && picker->scores[j - 1] < score) {
+            picker->moves.buf[j] = picker->moves.buf[j - 1];
+            picker->scores[j] = picker->scores[j - 1];
+            j -= 1;
+        }
+
+        picker->moves.buf[j] = move;
+        picker->scores[j] = score;
+    }
+}
+
+/// Check if the given move was already yielded by the hash stage or as one of the first `refutations` refutations
+static bool max_picker_yielded_early(max_picker_t *picker, max_smove_t move, uint8_t refutations) {
+    if(max_smove_eq(move, picker->hash)) {
+        return true;
+    }
+
+    for(uint8_t i = 0; i < refutations; ++i) {
+        if(max_smove_eq(move, picker->refutations[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool max_picker_next(max_picker_t *picker, max_engine_t *engine, max_smove_t *move) {
+    switch(picker->stage) {
+        case MAX_PICKER_STAGE_HASH: {
+            picker->stage = MAX_PICKER_STAGE_GENERATE;
+            if(
+                !max_smove_is_none(picker->hash) &&
+                max_board_pseudolegal(&engine->board, picker->hash) &&
+                max_board_legal(&engine->board, picker->hash)
+            ) {
+                *move = picker->hash;
+                return true;
+            }
+
+            //A hash move that is not valid in this position must not be skipped when generated
+            picker->hash = max_smove_none();
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_GENERATE: {
+            //Most nodes are cut by the hash move, so the legality masks are only computed once moves must be generated
+            max_board_legalmask(&engine->board, &picker->legal);
+            picker->evasion = max_check_has_value(max_board_state(&engine->board)->check[0]);
+            if(picker->evasion) {
+                max_picker_generate_evasions(picker, engine);
+            } else {
+                max_picker_generate_captures(picker, engine);
+            }
+
+            picker->stage = MAX_PICKER_STAGE_GOOD_CAPTURES;
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_GOOD_CAPTURES: {
+            while(picker->capture < picker->captures_end) {
+                max_picker_select(picker, picker->capture, picker->captures_end);
+                if(picker->scores[picker->capture] < 0) {
+                    break;
+                }
+
+                max_smove_t next = picker->moves.buf[picker->capture];
+                picker->capture += 1;
+                if(!max_smove_eq(next, picker->hash)) {
+                    *move = next;
+                    return true;
+                }
+            }
+
+            if(picker->tactical && !picker->evasion) {
+                picker->stage = MAX_PICKER_STAGE_DONE;
+                return false;
+            }
+
+            picker->stage = MAX_PICKER_STAGE_KILLERS;
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_KILLERS: {
+            while(picker->refutation < MAX_PICKER_REFUTATIONS_LEN) {
+                max_smove_t refutation = picker->refutations[picker->refutation];
+                picker->refutation += 1;
+                if(
+                    !max_smove_is_none(refutation) &&
+                    !max_picker_is_tactical(refutation) &&
+                    !max_picker_yielded_early(picker, refutation, picker->refutation - 1) &&
+                    max_board_pseudolegal(&engine->board, refutation) &&
+                    max_board_legal_masked(&engine->board, &picker->legal, refutation)
+                ) {
+                    *move = refutation;
+                    return true;
+                }
+            }
+
+            if(!picker->evasion) {
+                max_picker_generate_quiets(picker, engine);
+            }
+
+            max_picker_sort_quiets(picker);
+            picker->stage = MAX_PICKER_STAGE_QUIETS;
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_QUIETS: {
+            while(picker->quiet < picker->moves.len) {
+                max_smove_t next = picker->moves.buf[picker->quiet];
+                picker->quiet += 1;
+                if(!max_picker_yielded_early(picker, next, picker->refutation)) {
+                    *move = next;
+                    return true;
+                }
+            }
+
+            picker->stage = MAX_PICKER_STAGE_BAD_CAPTURES;
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_BAD_CAPTURES: {
+            while(picker->capture < picker->captures_end) {
+                max_picker_select(picker, picker->capture, picker->captures_end);
+                max_smove_t next = picker->moves.buf[picker->capture];
+                picker->capture += 1;
+                if(!max_smove_eq(next, picker->hash)) {
+                    *move = next;
+                    return true;
+                }
+            }
+
+            picker->stage = MAX_PICKER_STAGE_DONE;
+        } //fallthrough
+
+        case MAX_PICKER_STAGE_DONE: break;
+    }
+
+    return false;
+}
+
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "max/board/squares.h"
+#include "private/engine/engine.h"
+#include "private/test.h"
+
+void max_picker_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+    static max_smove_t buf[MAX_PICKER_CAPACITY];
+    ASSERT(
+        max_board_parse_from_fen(&engine->board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1") == MAX_FEN_SUCCESS,
+        "FEN parse when setting up move picker unit test fails"
+    );
+
+    max_movelist_t expected = (max_movelist_t){ .buf = buf, .capacity = MAX_PICKER_CAPACITY, .len = 0 };
+    max_board_movegen_legal(&engine->board, &expected);
+
+    max_smove_t hash = max_smove_normal(MAX_A2, MAX_A3);
+    max_smove_t killers[MAX_PICKER_KILLERS_LEN] = {
+        max_smove_normal(MAX_G2, MAX_G3),
+        max_smove_normal(MAX_B1, MAX_B3),
+    };
+
+    max_picker_t picker;
+    max_picker_new(&picker, max_movelist_slice(&engine->moves), hash, killers, max_smove_none());
+
+    uint8_t yielded[MAX_PICKER_CAPACITY] = {0};
+    unsigned count = 0;
+    unsigned killer_idx = 0;
+    unsigned last_good_capture = 0;
+    unsigned first_quiet = MAX_PICKER_CAPACITY;
+    unsigned unknown = 0;
+    bool hash_first = false;
+    max_smove_t move;
+
+    while(max_picker_next(&picker, engine, &move)) {
+        bool found = false;
+        for(unsigned i = 0; i < expected.len; ++i) {
+            if(max_smove_eq(expected.buf[i], move)) {
+                yielded[i] += 1;
+                found = true;
+            }
+        }
+
+        unknown += !found;
+        if(count == 0) {
+            hash_first = max_smove_eq(move, hash);
+        }
+
+        if(max_smove_eq(move, killers[0])) {
+            killer_idx = count;
+        } else if(picker.stage == MAX_PICKER_STAGE_GOOD_CAPTURES) {
+            last_good_capture = count;
+        } else if(picker.stage == MAX_PICKER_STAGE_QUIETS && first_quiet == MAX_PICKER_CAPACITY) {
+            first_quiet = count;
+        }
+
+        count += 1;
+    }
+
+    unsigned repeated = 0;
+    for(unsigned i = 0; i < expected.len; ++i) {
+        repeated += yielded[i] != 1;
+    }
+
+    ASSERT(hash_first, "Move picker does not yield the hash move first");
+    ASSERT(unknown == 0, "Move picker yields %u moves that were not generated", unknown);
+    ASSERT(repeated == 0, "Move picker does not yield %u generated moves exactly once", repeated);
+    ASSERT(
+        last_good_capture < killer_idx && killer_idx < first_quiet,
+        "Killer move is not yielded between good captures and quiet moves"
+    );
+
+    //Quiescence pickers drop a quiet hash move and stop after the good captures when not in check
+    max_picker_new_tactical(&picker, max_movelist_slice(&engine->moves), hash);
+    unsigned quiet = 0;
+    count = 0;
+    while(max_picker_next(&picker, engine, &move)) {
+        quiet += !max_picker_is_tactical(move);
+        count += 1;
+    }
+
+    ASSERT(count > 0 && quiet == 0, "Tactical move picker yields %u quiet moves out of %u", quiet, count);
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "private/engine/see.h"
+#include "max/board/piececode.h"
+#include "max/board/side.h"
+#include "private/board/board.h"
+#include "private/engine/eval.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Get the value of a piece that may be captured during an exchange
+static MAX_INLINE_ALWAYS int32_t max_engine_see_value(max_engine_t *engine, max_piececode_t piece) {
+    if((piece.v & MAX_PIECECODE_TYPE_MASK) == MAX_PIECECODE_KING) {
+        return MAX_ENGINE_SEE_KING;
+    }
+
+    return max_engine_score_piece(engine, piece);
+}
+
+max_score_t max_engine_see(max_engine_t *engine, max_smove_t move) {
+    max_board_t *board = &engine->board;
+
+    max_attackers_t attackers;
+    max_board_attackers(board, move.to, &attackers);
+
+    //gain[n] is the material won by the side making the nth capture if the exchange stopped after it
+    int32_t gain[MAX_ATTACKERS_CAP + 1];
+    bool used[MAX_ATTACKERS_CAP] = {false};
+
+    max_piececode_t moved = board->pieces[move.from.v];
+    int32_t on_square = max_engine_see_value(engine, moved);
+    gain[0] = 0;
+    if(move.tag & MAX_MOVETAG_CAPTURE) {
+        gain[0] = max_engine_see_value(engine, board->pieces[move.to.v]);
+    } else if(move.tag == MAX_MOVETAG_ENPASSANT) {
+        gain[0] = engine->param.material.pawn;
+    }
+
+    if(max_movetag_is_promote(move.tag)) {
+        max_piececode_t promoted = max_piececode_for_movetag_promote(move.tag, max_board_side(board));
+        on_square = max_engine_see_value(engine, promoted);
+        gain[0] += on_square - engine->param.material.pawn;
+    }
+
+    //The first capturer has already left its square, opening any x-ray attackers behind it
+    for(uint8_t i = 0; i < attackers.len; ++i) {
+        if(attackers.buf[i].loc.v == move.from.v) {
+            used[i] = true;
+        }
+    }
+
+    max_side_t side = max_board_enemy_side(board);
+    uint8_t depth = 0;
+    for(;;) {
+        uint8_t next = MAX_ATTACKER_DIRECT;
+        int32_t next_value = INT32_MAX;
+        for(uint8_t i = 0; i < attackers.len; ++i) {
+            max_attacker_t attacker = attackers.buf[i];
+            if(
+                used[i] ||
+                max_piececode_side(attacker.piece) != side ||
+                (attacker.behind != MAX_ATTACKER_DIRECT && !used[attacker.behind])
+            ) {
+                continue;
+            }
+
+            int32_t value = max_engine_see_value(engine, attacker.piece);
+            if(value < next_value) {
+                next = i;
+                next_value = value;
+            }
+        }
+
+        if(next == MAX_ATTACKER_DIRECT) {
+            break;
+        }
+
+        depth += 1;
+        gain[depth] = on_square - gain[depth - 1];
+
+        //Neither side can improve on the result by continuing the exchange
+        if(-gain[depth - 1] < 0 && gain[depth] < 0) {
+            break;
+        }
+
+        used[next] = true;
+        on_square = next_value;
+        side = max_side_enemy(side);
+    }
+
+    while(depth > 0) {
+        int32_t stand = -gain[depth - 1];
+        gain[depth - 1] = -(stand > gain[depth] ? stand : gain[depth]);
+        depth -= 1;
+    }
+
+    return (max_score_t)gain[0];
+}
+
+#ifdef MAX_TESTS
+#include "max/board/fen.h"
+#include "max/board/squares.h"
+#include "private/engine/engine.h"
+#include "private/test.h"
+
+void max_engine_see_unit_tests(void) {
+    max_engine_t *engine = max_engine_test_new();
+
+    static const struct {
+        char const *fen;
+        max_smove_t move;
+        max_score_t expected;
+    } CASES[] = {
+        //Undefended pawn
+        { "4k3/8/8/3p4/8/8/3R4/4K3 w - - 0 1", { .from = MAX_D2, .to = MAX_D5, .tag = MAX_MOVETAG_CAPTURE }, 100 },
+        //Queen takes a pawn defended by a pawn
+        { "4k3/8/4p3/3p4/8/8/3Q4/4K3 w - - 0 1", { .from = MAX_D2, .to = MAX_D5, .tag = MAX_MOVETAG_CAPTURE }, -900 },
+        //Rook backed by a queen on the same file wins a pawn defended by a rook
+        { "3rk3/8/8/3p4/8/8/3R4/3QK3 w - - 0 1", { .from = MAX_D2, .to = MAX_D5, .tag = MAX_MOVETAG_CAPTURE }, 100 },
+        //Without the queen behind, the rook is recaptured
+        { "3rk3/8/8/3p4/8/8/3R4/4K3 w - - 0 1", { .from = MAX_D2, .to = MAX_D5, .tag = MAX_MOVETAG_CAPTURE }, -400 },
+        //Knight takes a pawn defended by a bishop hidden behind a pawn
+        { "4k3/8/1b6/2p5/3p4/8/4N3/4K3 w - - 0 1", { .from = MAX_E2, .to = MAX_D4, .tag = MAX_MOVETAG_CAPTURE }, -200 },
+    };
+
+    for(unsigned i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i) {
+        max_board_parse_from_fen(&engine->board, CASES[i].fen);
+        max_score_t see = max_engine_see(engine, CASES[i].move);
+        ASSERT(
+            see == CASES[i].expected,
+            "Static exchange evaluation in %s is %d, expecting %d",
+            CASES[i].fen,
+            see,
+            CASES[i].expected
+        );
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "max/engine/engine.h"
+#include "max/board/board.h"
+#include "max/board/move.h"
+#include "max/engine/score.h"
+#include "private/engine/engine.h"
+#include "private/engine/search.h"
+
+#ifdef MAX_THREADS
+
+/// Entry point of a helper thread, running iterative deepening on a private copy of the board
+/// until the main thread raises the shared stop flag.
+static int max_engine_helper_main(void *data) {
+    max_engine_helper_t *helper = (max_engine_helper_t*)data;
+    max_search_result_t search = (max_search_result_t){
+        .score = MAX_SCORE_LOWEST,
+        .best = max_smove_normal(max_0x88_raw(MAX_0x88_INVALID_MASK), max_0x88_raw(MAX_0x88_INVALID_MASK)),
+        .depth = 0,
+        .gameover = false,
+        .lines_len = 0,
+    };
+
+    max_engine_iterate(&helper->engine, &search, helper->start_depth);
+    return 0;
+}
+
+uint8_t max_engine_helpers_start(max_engine_t *engine) {
+    for(uint8_t i = 0; i < engine->threads.count; ++i) {
+        max_engine_helper_t *helper = &engine->threads.buf[i];
+        
+        //Helpers share everything with the main engine by value, including the transposition table buffer,
+        //but must own the board state stack and move buffer that they modify while searching
+        helper->engine = *engine;
+        max_board_clone(&helper->engine.board, &engine->board, helper->stack);
+        max_movelist_new(&helper->engine.moves, helper->moves, MAX_ENGINE_HELPER_MOVES_CAP);
+        helper->engine.threads.buf = NULL;
+        helper->engine.threads.count = 0;
+        helper->engine.threads.running = 0;
+        helper->engine.info.callback = NULL;
+        helper->engine.stop = &engine->stop_signal;
+        helper->engine.nodes = 0;
+
+        //Stagger the starting depth so that half of the helpers search one ply ahead of the main thread
+        helper->start_depth = 2 + ((i & 1) ^ 1);
+
+        if(thrd_create(&helper->thread, max_engine_helper_main, helper) != thrd_success) {
+            return i;
+        }
+    }
+
+    return engine->threads.count;
+}
+
+void max_engine_helpers_join(max_engine_t *engine, uint8_t count, max_search_result_t *search) {
+    max_engine_flag_store(&engine->stop_signal, true);
+
+    for(uint8_t i = 0; i < count; ++i) {
+        max_engine_helper_t *helper = &engine->threads.buf[i];
+        thrd_join(helper->thread, NULL);
+        search->nodes += helper->engine.nodes;
+
+        DIAGNOSTIC(
+            engine->diagnostic.nodes += helper->engine.diagnostic.nodes;
+            engine->diagnostic.ttbl_hits += helper->engine.diagnostic.ttbl_hits;
+            engine->diagnostic.ttbl_used += helper->engine.diagnostic.ttbl_used;
+            engine->diagnostic.ttbl_cutoffs += helper->engine.diagnostic.ttbl_cutoffs;
+            engine->diagnostic.evalcache_probes += helper->engine.diagnostic.evalcache_probes;
+            engine->diagnostic.evalcache_hits += helper->engine.diagnostic.evalcache_hits;
+        );
+    }
+}
+
+#endif
@@ -2,51 +2,196 @@
 #include "max/assert.h"
 #include "private/engine/tt.h"
 #include <stddef.h>
-#include <stdio.h>
+#include <stdint.h>
 
-void max_ttbl_new(max_ttbl_t *tbl, max_ttentry_t *buf, uint8_t nbits) {
+void max_ttbl_new(max_ttbl_t *tbl, max_ttbucket_t *buf, uint8_t nbits) {
     MAX_ASSERT(nbits < 32 && "Cannot create a transposition table with a buffer larger than 4GiB");
     uint32_t capacity = 1 << nbits;
     for(uint32_t i = 0; i < capacity; ++i) {
-        buf[i] = max_ttentry_gravestone();
+        for(unsigned j = 0; j < MAX_TTBUCKET_LEN; ++j) {
+            max_ttentry_word_store(&buf[i].entries[j].key, 0);
+            max_ttentry_word_store(&buf[i].entries[j].data, 0);
+        }
     }
 
     tbl->buf = buf;
     tbl->nbit = nbits;
+    tbl->generation = 0;
 }
 
-max_ttentry_t const* max_ttbl_probe_read(max_ttbl_t *tbl, max_zobrist_t hash) {
-    max_ttentry_t *entry = &tbl->buf[max_ttbl_get_index(tbl, hash)];
+bool max_ttbl_probe_read(max_ttbl_t *tbl, max_zobrist_t hash, max_ttentry_data_t *data) {
+    max_ttbucket_t *bucket = &tbl->buf[max_ttbl_get_index(tbl, hash)];
+    
+    for(unsigned i = 0; i < MAX_TTBUCKET_LEN; ++i) {
+        //Load both words once - the entry may be overwritten by another thread between the loads,
+        //in which case the verification below will fail and the entry is rejected.
+        //No explicit check for empty entries - it is assumed that no position will ever hash to 0
+        uint64_t key = max_ttentry_word_load(&bucket->entries[i].key);
+        uint64_t read = max_ttentry_word_load(&bucket->entries[i].data);
 
-    //No explicit check for gravestone marker - assumed that 
-    //no key part will ever be the gravestone key, so this equal check will always fail
-    //for empty entries
-    if(entry->key == max_ttbl_get_key(tbl, hash)) {
-        return entry;
-    } else {
-        return NULL;
+        if((key ^ read) == (uint64_t)hash) {
+            *data = read;
+            return true;
+        }
     }
+
+    return false;
 }
 
-void max_ttbl_probe_insert(max_ttbl_t *tbl, max_zobrist_t hash, max_nodescore_t score, uint16_t ply) {
-    max_ttentry_t *entry = &tbl->buf[max_ttbl_get_index(tbl, hash)];
+/// Get a measure of how valuable it is to keep the given entry in the table, used to select the entry of a bucket
+/// that will be replaced.
+/// Deep entries are valuable, but lose value quickly with every search that passes after their creation.
+static int32_t max_ttbl_entry_worth(max_ttbl_t *tbl, uint64_t key, max_ttentry_data_t data) {
+    if(key == 0 && data == 0) {
+        return INT32_MIN;
+    }
+
+    uint8_t age = tbl->generation - max_ttentry_data_generation(data);
+    return (int32_t)max_ttentry_data_depth(data) - 8 * (int32_t)age;
+}
+
+void max_ttbl_probe_insert(max_ttbl_t *tbl, max_zobrist_t hash, max_nodescore_t score) {
+    max_ttbucket_t *bucket = &tbl->buf[max_ttbl_get_index(tbl, hash)];
+    max_ttentry_t *replace = NULL;
+    int32_t replace_worth = INT32_MAX;
+
+    for(unsigned i = 0; i < MAX_TTBUCKET_LEN; ++i) {
+        max_ttentry_t *entry = &bucket->entries[i];
+        uint64_t key = max_ttentry_word_load(&entry->key);
+        max_ttentry_data_t data = max_ttentry_word_load(&entry->data);
+
+        //The same position is already stored, only keep it if it holds a deeper search from this generation
+        if((key ^ data) == (uint64_t)hash) {
+            if(
+                score.kind != MAX_NODEKIND_PV &&
+                max_ttentry_data_generation(data) == tbl->generation &&
+                max_ttentry_data_depth(data) > score.depth
+            ) {
+                return;
+            }
+
+            replace = entry;
+            break;
+        }
 
-    if(entry->key != MAX_TTENTRY_KEY_GRAVESTONE) {
-        return;
-        uint8_t age = ply - entry->age;
-        if(score.depth < (entry->depth + (age >> 1)) && (ply - entry->age) < 6) {
-            return;
+        int32_t worth = max_ttbl_entry_worth(tbl, key, data);
+        if(worth < replace_worth) {
+            replace = entry;
+            replace_worth = worth;
         }
     }
 
-    entry->key = max_ttbl_get_key(tbl, hash);
-    entry->score = score.score;
-    entry->depth = score.depth;
-    entry->age = ply;
-    entry->attr = max_ttentry_pattr_new(
-        score.bestmove.from,
-        score.bestmove.to,
-        score.kind,
-        score.depth
+    max_ttentry_data_t data = max_ttentry_data_new(score, tbl->generation);
+    max_ttentry_word_store(&replace->key, (uint64_t)hash ^ data);
+    max_ttentry_word_store(&replace->data, data);
+}
+
+uint16_t max_ttbl_hashfull(max_ttbl_t *tbl) {
+    uint32_t capacity = (uint32_t)MAX_TTBUCKET_LEN << tbl->nbit;
+    uint32_t sample = (capacity < MAX_TTBL_HASHFULL_SAMPLE) ? capacity : MAX_TTBL_HASHFULL_SAMPLE;
+    uint32_t used = 0;
+
+    for(uint32_t i = 0; i < sample; ++i) {
+        max_ttentry_t *entry = &tbl->buf[i / MAX_TTBUCKET_LEN].entries[i % MAX_TTBUCKET_LEN];
+        uint64_t key = max_ttentry_word_load(&entry->key);
+        max_ttentry_data_t data = max_ttentry_word_load(&entry->data);
+        if((key != 0 || data != 0) && max_ttentry_data_generation(data) == tbl->generation) {
+            used += 1;
+        }
+    }
+
+    return (uint16_t)((used * 1000) / sample);
+}
+
+#ifdef MAX_TESTS
+#include "private/test.h"
+#include "max/board/squares.h"
+
+void max_ttbl_unit_tests(void) {
+    static max_ttbucket_t buf[16];
+    max_ttbl_t tbl;
+    max_ttbl_new(&tbl, buf, 4);
+
+    max_nodescore_t score = (max_nodescore_t){
+        .bestmove = max_smove_new(MAX_E7, MAX_F8, MAX_MOVETAG_CAPTURE | MAX_MOVETAG_PKNIGHT),
+        .score = -1234,
+        .kind = MAX_NODEKIND_CUT,
+        .depth = 9,
+    };
+
+    max_zobrist_t hash = 0x5A5A1235;
+    max_ttentry_data_t data;
+    ASSERT(!max_ttbl_probe_read(&tbl, hash, &data), "Empty transposition table returns an entry");
+    ASSERT(max_ttbl_hashfull(&tbl) == 0, "Empty transposition table is reported as %u permille full", max_ttbl_hashfull(&tbl));
+
+    max_ttbl_probe_insert(&tbl, hash, score);
+    ASSERT(max_ttbl_probe_read(&tbl, hash, &data), "Inserted entry cannot be read back");
+    ASSERT(
+        max_ttentry_data_score(data) == score.score &&
+        max_ttentry_data_depth(data) == score.depth &&
+        max_ttentry_data_kind(data) == score.kind &&
+        max_smove_eq(max_ttentry_data_move(data), score.bestmove),
+        "Entry read from the table does not match the inserted node score"
+    );
+
+    ASSERT(!max_ttbl_probe_read(&tbl, hash ^ 0x100, &data), "Index collision with a different hash returns an entry");
+    ASSERT(
+        max_ttbl_hashfull(&tbl) == 1000 / (16 * MAX_TTBUCKET_LEN),
+        "Table with one entry is reported as %u permille full", max_ttbl_hashfull(&tbl)
+    );
+
+    //Fill the remainder of the bucket with shallower positions sharing the same index
+    max_nodescore_t shallow = score;
+    shallow.depth = 2;
+    for(unsigned i = 1; i < MAX_TTBUCKET_LEN; ++i) {
+        max_ttbl_probe_insert(&tbl, hash ^ (i << 8), shallow);
+    }
+
+    ASSERT(
+        max_ttbl_probe_read(&tbl, hash, &data) && max_ttbl_probe_read(&tbl, hash ^ 0x100, &data),
+        "Positions sharing a bucket evict each other before the bucket is full"
+    );
+
+    //A shallower search of the same position in the same generation must not overwrite the deep entry
+    max_ttbl_probe_insert(&tbl, hash, shallow);
+    ASSERT(
+        max_ttbl_probe_read(&tbl, hash, &data) && max_ttentry_data_depth(data) == score.depth,
+        "Deep entry overwritten by a shallower search of the same position"
     );
+
+    //Within one generation, the shallowest entry is replaced when a new position is inserted into a full bucket
+    max_zobrist_t evicting = hash ^ (MAX_TTBUCKET_LEN << 8);
+    max_ttbl_probe_insert(&tbl, evicting, shallow);
+    ASSERT(
+        max_ttbl_probe_read(&tbl, evicting, &data) && max_ttbl_probe_read(&tbl, hash, &data),
+        "Deepest entry replaced instead of a shallow entry"
+    );
+
+    //Entries from old searches are replaced before deep entries are
+    max_ttbl_new_generation(&tbl);
+    max_ttbl_new_generation(&tbl);
+    max_ttbl_probe_insert(&tbl, evicting, shallow);
+    max_ttbl_probe_insert(&tbl, hash ^ (1 << 8), shallow);
+    for(unsigned i = 2; i < MAX_TTBUCKET_LEN; ++i) {
+        max_ttbl_probe_insert(&tbl, hash ^ ((MAX_TTBUCKET_LEN + i) << 8), shallow);
+    }
+
+    ASSERT(!max_ttbl_probe_read(&tbl, hash, &data), "Entry from an old search is not replaced by the current search");
+
+    //Simulate a torn write by replacing only the data word with the data of another node
+    max_ttbl_probe_insert(&tbl, hash, score);
+    max_ttbucket_t *bucket = &tbl.buf[max_ttbl_get_index(&tbl, hash)];
+    score.depth = 10;
+    for(unsigned i = 0; i < MAX_TTBUCKET_LEN; ++i) {
+        max_ttentry_t *entry = &bucket->entries[i];
+        uint64_t key = max_ttentry_word_load(&entry->key);
+        uint64_t read = max_ttentry_word_load(&entry->data);
+        if((key ^ read) == (uint64_t)hash) {
+            max_ttentry_word_store(&entry->data, max_ttentry_data_new(score, tbl.generation));
+        }
+    }
+
+    ASSERT(!max_ttbl_probe_read(&tbl, hash, &data), "Torn transposition table entry is not rejected");
 }
+
+#endif
@@ -24,6 +24,16 @@ MAX_INLINE_ALWAYS max_state_t* max_board_state(max_board_t *board) {
     return max_state_stack_peek(&board->stack);
 }
 
+/// Get the piece-square score of the given piece on the given square from the board's table
+MAX_INLINE_ALWAYS max_phasescore_t max_board_psqt_element(max_board_t *board, max_0x88_t pos, max_piececode_t piece) {
+    return board->psqt->score[max_piececode_side(piece)][max_piececode_kind_index(piece)][max_0x88_to_6bit(pos).v];
+}
+
+/// Get the phase weight of the given piece from the board's table
+MAX_INLINE_ALWAYS uint8_t max_board_psqt_phase(max_board_t *board, max_piececode_t piece) {
+    return board->psqt->phase[max_piececode_kind_index(piece)];
+}
+
 /// Set the A and H side rook files for both white and black.
 /// This initializes the piece lists for both sides with initial rook positions
 MAX_INLINE_ALWAYS void max_board_set_initial_rook_files(max_board_t *board, uint8_t aside, uint8_t hside) {
@@ -48,14 +58,45 @@ bool max_board_empty_between_with_dir(max_board_t *board, max_0x88_t from, max_0
 /// \return true if the given square is attacked by any sliding or jumping enemy piece
 bool max_board_square_is_attacked(max_board_t *board, max_0x88_t pos);
 
+/// Maximum number of pieces that may attack a single square directly or through other attackers
+#define MAX_ATTACKERS_CAP (32)
+
+/// Value of #max_attacker_t::behind for an attacker that has a clear line to the attacked square
+#define MAX_ATTACKER_DIRECT (0xFF)
+
+/// A single piece attacking a square, possibly through other pieces that attack the same square
+typedef struct {
+    /// Location of the attacking piece
+    max_0x88_t loc;
+    /// The attacking piece
+    max_piececode_t piece;
+    /// Index of the attacker standing between this piece and the attacked square, which must capture on the square
+    /// before this piece is able to attack it, or #MAX_ATTACKER_DIRECT
+    uint8_t behind;
+} max_attacker_t;
+
+/// All pieces of both sides attacking a single square, including x-ray attackers that are lined up behind
+/// other attackers on the same ray.
+/// An x-ray attacker is always stored after the attacker that it is hidden behind.
+typedef struct {
+    max_attacker_t buf[MAX_ATTACKERS_CAP];
+    uint8_t len;
+} max_attackers_t;
+
+/// Find every white and black piece attacking the given square, including sliders that are hidden behind other
+/// attackers on the same ray.
+/// The piece on the attacked square itself is never included.
+/// \param [out] attackers Filled with all attackers of the square
+void max_board_attackers(max_board_t *board, max_0x88_t pos, max_attackers_t *attackers);
+
 /// Add a piece to the board at the given position.
-/// Updates the current zobrist hash, adds a piece to it's corresponding side's piece list,
+/// Updates the current zobrist hash, piece-square score, and phase, adds a piece to it's corresponding side's piece list,
 /// updates the index and piece code boards as required.
 /// \note No bounds checking is performed on the piece lists except when debug assertions are enabled
 void max_board_add_piece_to_side(max_board_t *board, max_pieces_t *side, max_0x88_t pos, max_piececode_t piece);
 
 /// Remove the piece at the given position from the given side.
-/// Updates the board's zobrist hash, but does NOT update the capture stack (this must be done manually).
+/// Updates the board's zobrist hash, piece-square score, and phase, but does NOT update the capture stack (this must be done manually).
 /// \return The piece code of the piece that was removed from the given square
 max_piececode_t max_board_remove_piece_from_side(max_board_t *board, max_pieces_t *side, max_0x88_t pos);
 
@@ -104,6 +145,9 @@ MAX_INLINE_ALWAYS max_piececode_t max_board_remove_piece(max_board_t *board, max
 /// Perform unit tests for check detection
 void max_board_check_unit_tests(void);
 
+/// Ensure that attacker lists contain direct and x-ray attackers of both sides
+void max_board_attackers_unit_tests(void);
+
 void max_board_legality_unit_tests(void);
 
 void max_board_perft_unit_tests(void);
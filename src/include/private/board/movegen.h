@@ -3,6 +3,7 @@
 #include "max/board/board.h"
 #include "max/board/move.h"
 #include "max/board/piececode.h"
+#include "max/def.h"
 #include <stdbool.h>
 
 
@@ -24,6 +25,25 @@
 /// \return false If the destination square was invalid or if any piece (enemies included) occupied the given square (used for sliding movegen)
 bool max_board_movegen_attack(max_board_t *board, max_movelist_t *list, max_piecemask_t enemy, max_0x88_t from, max_0x88_t to);
 
+/// Generate a capture for a piece on the given source square if the given destination square is occupied by an enemy piece.
+/// \param enemy A bitmask that matches enemy pieces of the piece on #from
+/// \param from The square that a piece originates from
+/// \param to The square that is attacked by the piece on #from, which may be off the board
+MAX_INLINE_ALWAYS void max_board_movegen_capture(max_board_t *board, max_movelist_t *list, max_piecemask_t enemy, max_0x88_t from, max_0x88_t to) {
+    if(max_0x88_valid(to) && max_piececode_match(board->pieces[to.v], enemy)) {
+        max_movelist_add(list, max_smove_capture(from, to));
+    }
+}
+
+/// Generate a quiet move for a piece on the given source square if the given destination square is empty.
+/// \param from The square that a piece originates from
+/// \param to The square that the piece moves to, which may be off the board
+MAX_INLINE_ALWAYS void max_board_movegen_quiet(max_board_t *board, max_movelist_t *list, max_0x88_t from, max_0x88_t to) {
+    if(max_0x88_valid(to) && board->pieces[to.v].v == MAX_PIECECODE_EMPTY) {
+        max_movelist_add(list, max_smove_normal(from, to));
+    }
+}
+
 /// Update check for the side to play.
 /// This method updates the current state stack head's check structures to reflect the status of check after a a piece
 /// on the given source square is moved to a given destination square.
@@ -31,6 +51,11 @@ bool max_board_movegen_attack(max_board_t *board, max_movelist_t *list, max_piec
 /// move unmaking because we can just reuse the check structure stored on the stack.
 void max_board_update_check(max_board_t *board, max_smove_t move);
 
+/// Detect check for the side to play from scratch by testing every enemy piece for an attack on the king.
+/// This is much slower than max_board_update_check() and is only meant for positions that were not reached by
+/// making a move, such as those loaded from a FEN string.
+void max_board_detect_check(max_board_t *board);
+
 
 /// @}
 
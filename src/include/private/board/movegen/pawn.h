@@ -23,6 +23,14 @@
 /// \param side Side that the pawn belongs to
 void max_board_movegen_pawns(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_piecemask_t enemy, max_side_t side);
 
+/// Generate pseudo-legal captures, en passant captures, and promotions for all pawns of the given side.
+/// \see max_board_movegen_pawns()
+void max_board_movegen_pawn_captures(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_piecemask_t enemy, max_side_t side);
+
+/// Generate pseudo-legal single and double pushes that do not promote for all pawns of the given side.
+/// \see max_board_movegen_pawns()
+void max_board_movegen_pawn_quiets(max_board_t *board, max_movelist_t *list, max_pieces_t *pieces, max_side_t side);
+
 /// @}
 
 /// @}
@@ -21,6 +21,14 @@
 /// \param ray Increment to apply to each square along the line
 void max_board_movegen_slide(max_board_t *board, max_movelist_t *list, max_piecemask_t enemy, max_0x88_t source, max_0x88_dir_t ray);
 
+/// Generate the single capture (if any) available to a sliding attacker along the provided ray, skipping all quiet moves.
+/// \see max_board_movegen_slide()
+void max_board_movegen_slide_captures(max_board_t *board, max_movelist_t *list, max_piecemask_t enemy, max_0x88_t source, max_0x88_dir_t ray);
+
+/// Generate all quiet moves of a sliding piece along the provided ray, stopping at the first occupied square.
+/// \see max_board_movegen_slide()
+void max_board_movegen_slide_quiets(max_board_t *board, max_movelist_t *list, max_0x88_t source, max_0x88_dir_t ray);
+
 /// @}
 
 /// @}
@@ -33,6 +33,8 @@ MAX_INLINE_ALWAYS max_packed_state_t max_packed_state_set_epfile(max_packed_stat
 MAX_INLINE_ALWAYS max_state_t max_state_default(void) {
     return (max_state_t){
         .position = 0,
+        .pawns = 0,
+        .material = 0,
         .packed = 0xFF,
         .check = {
             max_check_empty(),
@@ -23,6 +23,15 @@ max_zobrist_t max_zobrist_position_element(max_zobrist_elements_t const *elems,
     return elems->position[max_piececode_side(piece)][max_piececode_kind_index(piece)][max_0x88_to_6bit(pos).v];
 }
 
+/// Get the zobrist material element that identifies a side having at least the given number of pieces of a type
+/// \param [in] elems Reference to statically initialized zobrist hash elements
+/// \param [in] piece The piece code of the given piece, only the type and color matter here
+/// \param [in] count Number of pieces of the same type and color on the board, not counting the given piece
+MAX_INLINE_ALWAYS
+max_zobrist_t max_zobrist_material_element(max_zobrist_elements_t const *elems, max_piececode_t piece, uint8_t count) {
+    return elems->material[max_piececode_side(piece)][max_piececode_kind_index(piece)][count];
+}
+
 /// Get the zobrist hash element identifying that the given side's castle rights have been removed
 /// \param [in] elems Reference to statically initialized zobrist elements to lookup rom
 /// \param [in] side The side that has lost castle rights
@@ -39,6 +48,12 @@ MAX_INLINE_ALWAYS max_zobrist_t max_zobrist_ep_file(max_zobrist_elements_t const
     return elems->en_passant_file[file];
 }
 
+/// Get the zobrist hash element that is toggled every time the side to play changes
+/// \param [in] elems Reference to already initialized zobrist hash elements
+MAX_INLINE_ALWAYS max_zobrist_t max_zobrist_side_element(max_zobrist_elements_t const *elems) {
+    return elems->black_to_play;
+}
+
 /// @}
 
 /// @}
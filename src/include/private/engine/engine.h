@@ -1,6 +1,10 @@
 #pragma once
 
+#include "max/board/movegen.h"
+#include "max/def.h"
 #include "max/engine/engine.h"
+#include "max/engine/tt.h"
+#include "private/board/board.h"
 
 
 #ifdef MAX_ENGINE_DIAGNOSTIC
@@ -9,4 +13,24 @@
 #define DIAGNOSTIC(...)
 #endif
 
-void max_engine_sortmoves(max_engine_t *engine, max_movelist_t moves);
+
+/// Make a move on the engine's board and immediately prefetch the transposition table bucket of the new position,
+/// so that the bucket is likely to be cached by the time the child node probes the table.
+MAX_INLINE_ALWAYS void max_engine_make_move(max_engine_t *engine, max_smove_t move) {
+    max_board_make_move(&engine->board, move);
+    max_ttbl_prefetch(&engine->table, max_board_state(&engine->board)->position);
+}
+
+#ifdef MAX_TESTS
+
+/// Capacity of the state stack of the engine returned by max_engine_test_new(), enough for a search of any depth
+#define MAX_ENGINE_TEST_STACK_CAP (MAX_ENGINE_MAX_PLY + 8)
+
+/// Capacity of the move buffer of the engine returned by max_engine_test_new()
+#define MAX_ENGINE_TEST_MOVES_CAP (MAX_ENGINE_MAX_PLY * MAX_ENGINE_MAX_MOVES_PER_PLY)
+
+/// Reset the engine shared by unit tests.
+/// The engine uses the default evaluation parameters and a single transposition table bucket, and its board is empty.
+max_engine_t *max_engine_test_new(void);
+
+#endif
@@ -3,6 +3,7 @@
 #include "max/board/loc.h"
 #include "max/board/piececode.h"
 #include "max/board/piecelist.h"
+#include "max/board/psqt.h"
 #include "max/def.h"
 #include "max/engine/engine.h"
 #include "max/engine/score.h"
@@ -12,27 +13,43 @@
 /// @{
 
 
-MAX_INLINE_ALWAYS max_score_t max_engine_score_positions_single(max_pstbl_t tbl, max_loclist_t *list, max_side_t side) {
+MAX_INLINE_ALWAYS max_score_t max_engine_score_positions_single(max_pstbl_t const tbl, max_loclist_t *list, max_side_t side) {
     max_score_t score = 0;
     for(unsigned i = 0; i < list->len; ++i) {
-        max_0x88_t pos = max_0x88_mirror_side(list->loc[i], side);
-        
-        score += tbl[max_0x88_to_6bit(pos).v];
+        score += tbl[max_pstbl_index(list->loc[i], side).v];
     }
 
     return score;
 }
 
-MAX_INLINE_ALWAYS max_score_t max_engine_score_positions(max_engine_t *engine, max_pieces_t *pieces, max_side_t side) {
+/// Score every piece of a side by a single phase's piece-square tables, iterating the side's piece lists
+MAX_INLINE_ALWAYS max_score_t max_engine_score_positions(max_engine_psqt_set_t const *set, max_pieces_t *pieces, max_side_t side) {
     return
-        max_engine_score_positions_single(engine->param.position.pawn, (max_loclist_t*)(&pieces->pawn), side) +
-        max_engine_score_positions_single(engine->param.position.knight, (max_loclist_t*)(&pieces->knight), side) +
-        max_engine_score_positions_single(engine->param.position.bishop, (max_loclist_t*)(&pieces->bishop), side) +
-        max_engine_score_positions_single(engine->param.position.rook, (max_loclist_t*)(&pieces->rook), side) +
-        max_engine_score_positions_single(engine->param.position.queen, (max_loclist_t*)(&pieces->queen), side) +
-        max_engine_score_positions_single(engine->param.position.king, (max_loclist_t*)(&pieces->king), side);
+        max_engine_score_positions_single(set->pawn, (max_loclist_t*)(&pieces->pawn), side) +
+        max_engine_score_positions_single(set->knight, (max_loclist_t*)(&pieces->knight), side) +
+        max_engine_score_positions_single(set->bishop, (max_loclist_t*)(&pieces->bishop), side) +
+        max_engine_score_positions_single(set->rook, (max_loclist_t*)(&pieces->rook), side) +
+        max_engine_score_positions_single(set->queen, (max_loclist_t*)(&pieces->queen), side) +
+        max_engine_score_positions_single(set->king, (max_loclist_t*)(&pieces->king), side);
 }
 
+/// Interpolate between the midgame and endgame halves of a score by the phase of the board, clamping phases raised
+/// above the starting phase by promotions.
+MAX_INLINE_ALWAYS max_score_t max_engine_taper(max_psqt_t const *psqt, max_phasescore_t score, uint8_t phase) {
+    int32_t mg = (phase > psqt->phase_max) ? psqt->phase_max : phase;
+    int32_t eg = psqt->phase_max - mg;
+    return (max_score_t)((score.mg * mg + score.eg * eg) / psqt->phase_max);
+}
+
+/// Build the table of scores accumulated by the board for every piece on every square, combining the material value
+/// of each piece with its piece-square table entry.
+/// \param [out] psqt Table to fill, mirrored and negated for black pieces
+/// \param [in] param Evaluation parameters to take material values and piece-square tables from
+void max_engine_psqt_build(max_psqt_t *psqt, max_eval_params_t const *param);
+
+/// Clear all entries of the engine's evaluation cache
+void max_engine_evalcache_clear(max_engine_t *engine);
+
 /// Get a score for the given piececode, regardless of the side that is played
 MAX_INLINE_ALWAYS max_score_t max_engine_score_piece(max_engine_t *engine, max_piececode_t piece) {
     return engine->param.material.array[max_piececode_kind_index(piece)];
@@ -0,0 +1,33 @@
+/// \file endgame.h
+#pragma once
+#include "max/board/board.h"
+#include "max/def.h"
+#include "max/engine/engine.h"
+#include "max/engine/eval/endgame.h"
+#include "max/engine/eval/material.h"
+
+/// \ingroup endgame
+/// @{
+
+/// Evaluate the material balance of the given board from scratch.
+/// \param [out] entry Filled with the imbalance and endgame functions of the board's material, except for the key
+/// \param [in] board The board to count pieces of
+/// \param [in] param Imbalance adjustments to apply
+void max_engine_material_eval(max_materialentry_t *entry, max_board_t *board, max_engine_imbalance_param_t const *param);
+
+/// Get the material balance evaluation for the current position of the engine's board from the material table,
+/// evaluating and storing it if the balance is not in the table.
+/// \return Material table entry for the current balance, valid until the next probe
+max_materialentry_t const* max_engine_material_probe(max_engine_t *engine);
+
+/// Clear all entries of the engine's material table
+void max_engine_material_clear(max_engine_t *engine);
+
+#ifdef MAX_TESTS
+
+/// Ensure that endgames are recognized by their material and that endgame evaluators make progress towards a win
+void max_engine_endgame_unit_tests(void);
+
+#endif
+
+/// @}
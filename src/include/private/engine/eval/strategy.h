@@ -1,12 +1,45 @@
 /// \file strategy.h
 #pragma once
+#include "max/board/board.h"
+#include "max/board/loc.h"
+#include "max/board/side.h"
+#include "max/def.h"
+#include "max/engine/engine.h"
+#include "max/engine/eval/pawns.h"
+#include "max/engine/eval/strategy.h"
+#include "max/engine/score.h"
 
 /// \ingroup strat
 /// @{
 
+/// Evaluate the pawn structure of the given board from scratch.
+/// \param [out] entry Filled with the pawn structure terms of the board, except for the key
+/// \param [in] board The board to scan for pawns of both sides
+/// \param [in] param Scores for each pawn structure term
+void max_engine_pawns_eval(max_pawnentry_t *entry, max_board_t *board, max_engine_strat_param_t const *param);
+
+/// Get the pawn structure evaluation for the current position of the engine's board from the pawn table, evaluating
+/// and storing it if the structure is not in the table.
+/// \return Pawn table entry for the current pawn structure, valid until the next probe
+max_pawnentry_t const* max_engine_pawns_probe(max_engine_t *engine);
+
+/// Clear all entries of the engine's pawn table
+void max_engine_pawns_clear(max_engine_t *engine);
+
+/// Get an outpost bonus for a piece on the given square.
+/// \param outpost_bonus The score to return for an outpost square
+/// \param [in] entry Pawn structure of the board
+/// \param sq Square of the piece to check for outposting
+/// \param side The side of the piece on the square
+/// \return The value of the outpost_bonus parameter if the square is an outpost for the given side, or 0
+MAX_INLINE_ALWAYS
+max_score_t max_engine_outpost(max_score_t outpost_bonus, max_pawnentry_t const *entry, max_0x88_t sq, max_side_t side) {
+    return ((entry->outposts[side] >> max_0x88_to_6bit(sq).v) & 1) ? outpost_bonus : 0;
+}
+
 #ifdef MAX_TESTS
 
-/// Test that strategy detection functions as expected with outpost squares
+/// Test that strategy detection functions as expected with outpost squares and pawn structure
 void max_engine_strategic_eval_tests(void);
 
 #endif
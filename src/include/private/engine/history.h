@@ -0,0 +1,64 @@
+/// \file history.h
+#pragma once
+
+#include "max/board/loc.h"
+#include "max/board/move.h"
+#include "max/board/side.h"
+#include "max/def.h"
+#include "max/engine/engine.h"
+#include "max/engine/score.h"
+#include <stdint.h>
+
+/// \ingroup engine
+/// @{
+
+/// \defgroup history Quiet Move Heuristics
+/// Killer moves, butterfly history, and countermoves remember which quiet moves caused beta cutoffs so that they can
+/// be searched early in sibling nodes, where they are likely to cause cutoffs again.
+/// @{
+
+/// Maximum number of quiet moves searched before a cutoff that are penalized in the history table
+#define MAX_ENGINE_HISTORY_QUIETS_CAP (64)
+
+/// Clear all heuristics, to be used when the engine is created or a new game begins
+void max_engine_heuristics_clear(max_engine_heuristics_t *heuristics);
+
+/// Prepare the heuristics for a new search by clearing killer moves that are specific to the previous root position
+/// and halving every history score so that newer cutoffs take precedence.
+void max_engine_heuristics_new_search(max_engine_heuristics_t *heuristics);
+
+/// Record a quiet move that caused a beta cutoff at the given ply.
+/// \param ply Distance of the node from the root position
+/// \param side Side to play at the node
+/// \param move The quiet move that caused the cutoff
+/// \param quiets Quiet moves that were searched before the cutoff move without causing a cutoff
+/// \param quiets_len Number of moves in #quiets
+/// \param depth Remaining depth of the node, deeper cutoffs are rewarded more
+void max_engine_heuristics_cutoff(
+    max_engine_heuristics_t *heuristics,
+    uint8_t ply,
+    max_side_t side,
+    max_smove_t move,
+    max_smove_t const *quiets,
+    uint8_t quiets_len,
+    uint8_t depth
+);
+
+/// Get the history score of a quiet move for the given side
+MAX_INLINE_ALWAYS max_score_t max_engine_history_score(max_engine_heuristics_t *heuristics, max_side_t side, max_smove_t move) {
+    return heuristics->history[side][max_0x88_to_6bit(move.from).v][max_0x88_to_6bit(move.to).v];
+}
+
+/// Get the quiet move that last refuted the move leading to the node at the given ply, or a placeholder at the root
+MAX_INLINE_ALWAYS max_smove_t max_engine_countermove(max_engine_heuristics_t *heuristics, uint8_t ply) {
+    if(ply == 0) {
+        return max_smove_none();
+    }
+
+    max_smove_t previous = heuristics->stack[ply - 1].move;
+    return heuristics->counter[max_0x88_to_6bit(previous.from).v][max_0x88_to_6bit(previous.to).v];
+}
+
+/// @}
+
+/// @}
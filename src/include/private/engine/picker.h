@@ -0,0 +1,111 @@
+/// \file picker.h
+#pragma once
+
+#include "max/board/move.h"
+#include "max/board/movegen.h"
+#include "max/def.h"
+#include "max/engine/engine.h"
+#include "max/engine/score.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/// \ingroup engine
+/// @{
+
+/// \defgroup picker Staged Move Picker
+/// Lazily yields the moves of a node in the order that they are most likely to cause a cutoff.
+/// Most cut nodes are refuted by the first or second move searched, so moves are produced in stages and the work
+/// required for a later stage is only done once every earlier stage has been exhausted.
+/// @{
+
+/// Stage of a #max_picker_t, determining which kind of move will be yielded next.
+typedef uint8_t max_picker_stage_t;
+
+enum {
+    /// Yield the move stored in the transposition table for this position without generating any moves
+    MAX_PICKER_STAGE_HASH,
+    /// Generate and score captures and promotions only, or every check evasion when in check
+    MAX_PICKER_STAGE_GENERATE,
+    /// Yield captures and promotions that do not lose material by static exchange evaluation, best exchange first
+    MAX_PICKER_STAGE_GOOD_CAPTURES,
+    /// Yield quiet moves that caused cutoffs in sibling nodes, followed by the countermove to the previous move
+    MAX_PICKER_STAGE_KILLERS,
+    /// Yield all remaining quiet moves by history score, which are only generated once this stage is reached when not in check
+    MAX_PICKER_STAGE_QUIETS,
+    /// Yield captures that lose material by static exchange evaluation
+    MAX_PICKER_STAGE_BAD_CAPTURES,
+    /// All moves have been yielded
+    MAX_PICKER_STAGE_DONE,
+};
+
+/// Maximum number of moves that a #max_picker_t can order, greater than the number of pseudo-legal moves
+/// possible in any chess position.
+#define MAX_PICKER_CAPACITY (256)
+
+/// Number of killer moves that may be provided to a #max_picker_t
+#define MAX_PICKER_KILLERS_LEN (MAX_ENGINE_KILLERS_LEN)
+
+/// Number of quiet refutations yielded in the #MAX_PICKER_STAGE_KILLERS stage: every killer and the countermove
+#define MAX_PICKER_REFUTATIONS_LEN (MAX_PICKER_KILLERS_LEN + 1)
+
+/// State of the staged move picker for a single node of the search.
+typedef struct {
+    /// Moves generated for the node, backed by the engine's move stack.
+    /// Child nodes must be given a slice of this list so that they do not overwrite the node's moves.
+    max_movelist_t moves;
+    /// Ordering scores for every move in #moves
+    max_score_t scores[MAX_PICKER_CAPACITY];
+    /// Move from the transposition table, or a placeholder if none was found
+    max_smove_t hash;
+    /// Killer moves followed by the countermove, any of which may be placeholders
+    max_smove_t refutations[MAX_PICKER_REFUTATIONS_LEN];
+    /// Pins and check evasion squares of the node, computed when the first moves are generated
+    max_legalmask_t legal;
+    /// Index of the next capture to consider in #moves
+    uint16_t capture;
+    /// Index one past the last capture or promotion in #moves, quiet moves follow
+    uint16_t captures_end;
+    /// Index of the next quiet move to consider in #moves
+    uint16_t quiet;
+    /// Index of the next refutation to consider in #refutations
+    uint8_t refutation;
+    /// Current stage of the picker
+    max_picker_stage_t stage;
+    /// If the side to play is in check, so that all evasions were generated in the #MAX_PICKER_STAGE_GENERATE stage
+    bool evasion;
+    /// If only the hash move and good captures are yielded when not in check, see max_picker_new_tactical()
+    bool tactical;
+} max_picker_t;
+
+/// Create a new move picker for the current node of the engine's board.
+/// \param moves Empty move list that generated moves will be stored to
+/// \param hash Move from the transposition table, which may be a placeholder or a move from a different position
+/// \param killers Array of #MAX_PICKER_KILLERS_LEN killer moves for the current ply, or NULL if none are tracked
+/// \param counter Quiet move that last refuted the opponent's previous move, or a placeholder
+void max_picker_new(max_picker_t *picker, max_movelist_t moves, max_smove_t hash, max_smove_t const *killers, max_smove_t counter);
+
+/// Create a new move picker for quiescence search that yields only the hash move and captures or promotions that do
+/// not lose material by static exchange evaluation, or every evasion if the side to play is in check.
+/// \param hash Move from the transposition table, which is discarded unless it is a capture or promotion
+void max_picker_new_tactical(max_picker_t *picker, max_movelist_t moves, max_smove_t hash);
+
+/// Check if the given move changes material, and should be searched before quiet moves
+MAX_INLINE_ALWAYS bool max_picker_is_tactical(max_smove_t move) {
+    return (move.tag & MAX_MOVETAG_CAPTURE) || move.tag == MAX_MOVETAG_ENPASSANT || max_movetag_is_promote(move.tag);
+}
+
+/// Get the next legal move to search, generating more moves if required.
+/// \param [out] move Filled with the next move to search
+/// \return false if all moves have been yielded
+bool max_picker_next(max_picker_t *picker, max_engine_t *engine, max_smove_t *move);
+
+#ifdef MAX_TESTS
+
+/// Ensure that the move picker yields every legal move exactly once in stage order
+void max_picker_unit_tests(void);
+
+#endif
+
+/// @}
+
+/// @}
@@ -1,11 +1,101 @@
 #pragma once
 
 
+#include "max/def.h"
 #include "max/engine/engine.h"
 #include "max/engine/score.h"
+#include <stdint.h>
 
 void max_engine_sort();
 
+/// Load a shared flag of the engine, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS bool max_engine_flag_load(max_engine_flag_t const *flag) {
+    #ifdef MAX_THREADS
+    return atomic_load_explicit(flag, memory_order_acquire);
+    #else
+    return *flag;
+    #endif
+}
+
+/// Store a shared flag of the engine, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS void max_engine_flag_store(max_engine_flag_t *flag, bool value) {
+    #ifdef MAX_THREADS
+    atomic_store_explicit(flag, value, memory_order_release);
+    #else
+    *flag = value;
+    #endif
+}
+
+/// Load a shared counter of the engine, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS uint64_t max_engine_word_load(max_engine_word_t const *word) {
+    #ifdef MAX_THREADS
+    return atomic_load_explicit(word, memory_order_relaxed);
+    #else
+    return *word;
+    #endif
+}
+
+/// Store a shared counter of the engine, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS void max_engine_word_store(max_engine_word_t *word, uint64_t value) {
+    #ifdef MAX_THREADS
+    atomic_store_explicit(word, value, memory_order_relaxed);
+    #else
+    *word = value;
+    #endif
+}
+
+/// Minimum remaining depth at which a null move is tried
+#define MAX_ENGINE_NULL_MIN_DEPTH (3)
+
+/// Minimum remaining depth at which a null move cutoff is verified by a reduced search without null moves,
+/// guarding against zugzwang positions that null move pruning would otherwise misjudge
+#define MAX_ENGINE_NULL_VERIFY_DEPTH (6)
+
+/// Depth reduction of the null move search, reduced further for deeper nodes
+MAX_INLINE_ALWAYS uint8_t max_engine_null_reduction(uint8_t depth) {
+    return depth >= MAX_ENGINE_NULL_VERIFY_DEPTH ? 3 : 2;
+}
+
+/// Minimum remaining depth at which late moves are searched with a reduced depth
+#define MAX_ENGINE_LMR_MIN_DEPTH (3)
+
+/// Number of moves searched at full depth from a node before late move reductions begin
+#define MAX_ENGINE_LMR_MIN_MOVES (3)
+
+/// Number of move indices in the late move reduction table, later moves share the last column
+#define MAX_ENGINE_LMR_MOVES_LEN (64)
+
+/// Late move reduction table indexed by remaining depth and the number of moves searched from the node so far.
+/// Reductions grow with the logarithm of both, as late moves in deep nodes are the least likely to raise alpha.
+extern uint8_t MAX_ENGINE_LMR[MAX_ENGINE_MAX_PLY][MAX_ENGINE_LMR_MOVES_LEN];
+
+/// Initialize the late move reduction table
+void max_engine_init_static(void);
+
+/// Get the depth reduction for a late move at a node with the given remaining depth
+/// \param movenum Number of moves searched from the node, including this move
+MAX_INLINE_ALWAYS uint8_t max_engine_lmr_reduction(uint8_t depth, uint8_t movenum) {
+    if(depth >= MAX_ENGINE_MAX_PLY) {
+        depth = MAX_ENGINE_MAX_PLY - 1;
+    }
+
+    if(movenum >= MAX_ENGINE_LMR_MOVES_LEN) {
+        movenum = MAX_ENGINE_LMR_MOVES_LEN - 1;
+    }
+
+    return MAX_ENGINE_LMR[depth][movenum];
+}
+
+/// Lowest bound of the full search window, leaving room below it for mate scores
+#define MAX_ENGINE_WINDOW_LOWEST (MAX_SCORE_LOWEST + 20)
+
+/// Highest bound of the full search window, leaving room above it for mate scores
+#define MAX_ENGINE_WINDOW_HIGHEST (MAX_SCORE_HIGHEST - 20)
+
+/// Initial half-width of the aspiration window placed around the score of the previous iteration, doubled
+/// every time the search fails outside of it
+#define MAX_ENGINE_ASPIRATION_WINDOW (25)
+
 typedef enum {
     MAX_ENGINE_STOP_SEARCH_DONE,
     MAX_ENGINE_STOP_TIMECONTROL,
@@ -22,6 +112,66 @@ max_engine_stop_t max_engine_negamax(
     uint8_t depth
 );
 
-/// Perform quiescence search to stabilize the results of a negamax search, ensuring that there are no obvious captures
-/// or checks available.
-max_score_t max_engine_quiesce(max_engine_t *engine, max_movelist_t moves, max_score_t alpha, max_score_t beta, uint8_t depth);
+/// Get the number of milliseconds that may be spent searching for the side to play under the given limits,
+/// or UINT64_MAX if the search is not limited by time.
+uint64_t max_engine_time_budget(max_search_limits_t const *limits, max_side_t side);
+
+/// Run a search as max_engine_search() does, but without clearing the stop flag first so that a stop requested
+/// before an asynchronous search thread begins running is not lost.
+void max_engine_search_run(max_engine_t *engine, max_search_limits_t const *limits, max_search_result_t *search);
+
+/// Search the root position of the given engine with iterative deepening until the time control is exceeded
+/// or the search is stopped, updating the given search result after every completed depth.
+/// \param start_depth The depth of the first iteration
+void max_engine_iterate(max_engine_t *engine, max_search_result_t *search, uint8_t start_depth);
+
+/// Report a completed iteration of the given search to the engine's info callback, if any
+void max_engine_info_iteration(max_engine_t *engine, max_search_result_t const *search);
+
+/// Send a periodic report to the engine's info callback if the report interval has elapsed
+/// \param now Current monotonic clock time in milliseconds
+void max_engine_info_poll(max_engine_t *engine, uint64_t now);
+
+#ifdef MAX_THREADS
+
+/// Copy the root position of the given engine to all of its helper threads and begin searching with each.
+/// \return The number of helper threads that were successfully started
+uint8_t max_engine_helpers_start(max_engine_t *engine);
+
+/// Raise the stop flag shared with all running helper threads and wait for them to exit,
+/// adding the nodes searched by every helper to the given search result.
+/// \param count Number of helper threads that were started by max_engine_helpers_start()
+void max_engine_helpers_join(max_engine_t *engine, uint8_t count, max_search_result_t *search);
+
+#endif
+
+#ifdef MAX_TESTS
+
+#ifdef MAX_THREADS
+
+/// Upper bound in microseconds on the stop latency accepted by max_engine_async_unit_tests()
+#define MAX_ENGINE_ASYNC_TEST_LATENCY_US (250000)
+
+/// Ensure that ponder searches wait for a ponder hit and that stopping a search is timely and measured
+void max_engine_async_unit_tests(void);
+
+#endif
+
+/// Ensure that searching a checkmated or stalemated root reports the end of the game without a move
+void max_engine_search_unit_tests(void);
+
+#endif
+
+/// Maximum number of check extensions applied to a single line, so that the nominal depth plus every extension
+/// stays within #MAX_ENGINE_MAX_PLY
+#define MAX_ENGINE_CHECK_EXTENSIONS (MAX_ENGINE_MAX_PLY - MAX_ENGINE_MAX_DEPTH)
+
+/// Margin in centipawns added to the material won by a capture in quiescence search before it is pruned for being
+/// unable to raise alpha, covering the positional gain that may accompany the capture
+#define MAX_ENGINE_DELTA_MARGIN (200)
+
+/// Perform quiescence search to stabilize the results of a negamax search, searching captures until the position
+/// is quiet and searching every evasion when in check.
+/// Captures that lose material by static exchange or that cannot raise alpha by the material they win are pruned,
+/// and results are stored to the transposition table at depth 0.
+max_score_t max_engine_quiesce(max_engine_t *engine, max_movelist_t moves, max_score_t alpha, max_score_t beta);
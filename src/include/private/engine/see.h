@@ -0,0 +1,35 @@
+/// \file see.h
+#pragma once
+
+#include "max/board/move.h"
+#include "max/engine/engine.h"
+#include "max/engine/score.h"
+
+/// \ingroup engine
+/// @{
+
+/// \defgroup see Static Exchange Evaluation
+/// Estimates the material won or lost by a capture by playing out every capture and recapture on the destination
+/// square with the least valuable attacker of each side, without searching.
+/// Pins and checks are ignored, so the result is only an approximation used to order and prune captures.
+/// @{
+
+/// Value of a king in the static exchange evaluation, large enough that a king never captures a defended piece
+#define MAX_ENGINE_SEE_KING (10000)
+
+/// Get the expected material gain of the given capture or promotion for the side to play, assuming that both sides
+/// may stop capturing on the destination square whenever continuing would lose material.
+/// \param move A pseudo-legal capture, en passant capture, or promotion on the engine's board
+/// \return The material gained by the side to play, which is negative if the move loses material
+max_score_t max_engine_see(max_engine_t *engine, max_smove_t move);
+
+#ifdef MAX_TESTS
+
+/// Ensure that exchanges including x-ray attackers are evaluated correctly
+void max_engine_see_unit_tests(void);
+
+#endif
+
+/// @}
+
+/// @}
@@ -3,27 +3,44 @@
 #include "max/def.h"
 #include "max/engine/tt.h"
 
+#ifdef MAX_THREADS
+#include <stdatomic.h>
+#endif
+
 /// \ingroup tt
 /// @{
 
 /// \name Private Functions
 /// @{
 
-/// A gravestone marker for nonexistent transposition table entry keys indicating that there is
-/// no entry at the given slot.
-/// Hopefull this key will never actually be created by the zobrist hash function.
-#define MAX_TTENTRY_KEY_GRAVESTONE (0)
+/// Load a single word of a transposition table entry, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS uint64_t max_ttentry_word_load(max_ttentry_word_t const *word) {
+    #ifdef MAX_THREADS
+    return atomic_load_explicit(word, memory_order_relaxed);
+    #else
+    return *word;
+    #endif
+}
 
-/// Get a transposition table entry with a marker that the entry has no valid evaluation yet.
-MAX_INLINE_ALWAYS max_ttentry_t max_ttentry_gravestone(void) {
-    return (max_ttentry_t){
-        .key = MAX_TTENTRY_KEY_GRAVESTONE,
-    };
+/// Store a single word of a transposition table entry, atomically if multiple threads are enabled.
+MAX_INLINE_ALWAYS void max_ttentry_word_store(max_ttentry_word_t *word, uint64_t value) {
+    #ifdef MAX_THREADS
+    atomic_store_explicit(word, value, memory_order_relaxed);
+    #else
+    *word = value;
+    #endif
 }
 
 /// Initialize the given transposition table with the given buffer and bit capacity.
-void max_ttbl_new(max_ttbl_t *tbl, max_ttentry_t *buf, uint8_t nbits);
+void max_ttbl_new(max_ttbl_t *tbl, max_ttbucket_t *buf, uint8_t nbits);
+
+#ifdef MAX_TESTS
+
+/// Ensure that entries survive a round trip through the table, that buckets replace the least valuable entry,
+/// and that torn entries are rejected
+void max_ttbl_unit_tests(void);
 
+#endif
 
 /// @}
 
@@ -6,6 +6,10 @@
 #include "private/board/piececode.h"
 #include "private/board/piecelist.h"
 #include "private/engine/eval.h"
+#include "private/engine/picker.h"
+#include "private/engine/search.h"
+#include "private/engine/see.h"
+#include "private/engine/tt.h"
 #include "private/test.h"
 #include "private/board/dir.h"
 
@@ -19,6 +23,7 @@ void max_init(void) {
     MAX_INITIALIZED = true;
 #endif
     max_0x88_init_static();
+    max_engine_init_static();
 }
 
 #ifdef MAX_TESTS
@@ -34,6 +39,13 @@ void max_unit_tests(void) {
     CATEGORY(max_pieces_unit_tests, "piece list unit tests");
     CATEGORY(max_piececode_unit_tests, "piece code unit tests");
     CATEGORY(max_engine_eval_tests, "engine evaluation unit tests");
+    CATEGORY(max_ttbl_unit_tests, "transposition table unit tests");
+    CATEGORY(max_picker_unit_tests, "move picker unit tests");
+    CATEGORY(max_engine_see_unit_tests, "static exchange evaluation unit tests");
+    CATEGORY(max_engine_search_unit_tests, "search unit tests");
+    #ifdef MAX_THREADS
+    CATEGORY(max_engine_async_unit_tests, "asynchronous search unit tests");
+    #endif
     printf("Max Unit Tests Summary - %u / %u passed\n", _max_tests - _max_failed_tests, _max_tests);
 }
 